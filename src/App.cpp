@@ -42,8 +42,12 @@
 #include <cursespp/Screen.h>
 #include <f8n/str/utf.h>
 #include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstring>
 #include <thread>
 #include <iostream>
+#include <fstream>
 
 #ifdef WIN32
 #include <cursespp/Win32Util.h>
@@ -52,7 +56,6 @@
 #endif
 
 #ifndef WIN32
-#include <csignal>
 #include <cstdlib>
 #include <locale.h>
 #endif
@@ -62,8 +65,19 @@ using namespace std::chrono;
 using namespace f8n::utf;
 
 static OverlayStack overlays;
+static LatencyTracker latency;
+static NotificationCenter notifications;
 static bool disconnected = false;
+static volatile std::sig_atomic_t resized = 0;
 static int64_t resizeAt = 0;
+static App::Clock virtualClock;
+
+struct BackgroundThread {
+    std::thread thread;
+    std::shared_ptr<std::atomic<bool>> done;
+};
+
+static std::vector<BackgroundThread> backgroundThreads;
 
 static App* instance = nullptr;
 
@@ -72,9 +86,9 @@ static void hangupHandler(int signal) {
     disconnected = true;
 }
 
+/* only sets a flag; the main loop does the rest, outside of the handler */
 static void resizedHandler(int signal) {
-    endwin(); /* required in *nix because? */
-    resizeAt = App::Now() + REDRAW_DEBOUNCE_MS;
+    resized = 1;
 }
 
 static bool isLangUtf8() {
@@ -125,7 +139,62 @@ App::App(const std::string& title) {
 }
 
 App::~App() {
+    /* workers may still post to the message queue, so they finish first */
+    for (auto& background : backgroundThreads) {
+        background.thread.join();
+    }
+    backgroundThreads.clear();
+
     endwin();
+
+    if (this->headlessScreen) {
+        delscreen(this->headlessScreen);
+        fclose(this->headlessIn);
+        fclose(this->headlessOut);
+    }
+
+    /* after endwin() so the report doesn't get clobbered by curses */
+    if (latency.IsEnabled()) {
+        if (this->latencyReportFilename.size()) {
+            std::ofstream out(this->latencyReportFilename.c_str());
+            out << latency.Report();
+        }
+        else {
+            std::cerr << latency.Report();
+        }
+    }
+}
+
+void App::InitHeadless() {
+#ifdef WIN32
+    throw std::runtime_error("headless mode is not supported on this platform");
+#else
+    this->headlessIn = fopen("/dev/null", "r");
+    this->headlessOut = fopen("/dev/null", "w");
+
+    if (!this->headlessIn || !this->headlessOut) {
+        throw std::runtime_error("unable to open null device for headless mode");
+    }
+
+    /* use a fixed, capable terminal type so runs are comparable regardless of
+    the environment they are launched from. */
+    if (this->colorMode == Colors::DirectRGB) {
+        this->headlessScreen = newterm(
+            "xterm-direct", this->headlessOut, this->headlessIn);
+    }
+
+    if (!this->headlessScreen) {
+        this->headlessScreen = newterm(
+            "xterm-256color", this->headlessOut, this->headlessIn);
+    }
+
+    if (!this->headlessScreen) {
+        throw std::runtime_error("unable to create headless terminal");
+    }
+
+    set_term(this->headlessScreen);
+    resize_term(this->headlessHeight, this->headlessWidth);
+#endif
 }
 
 void App::InitCurses() {
@@ -136,7 +205,13 @@ void App::InitCurses() {
     PDC_set_color_intensify_enabled(false);
 #endif
 
-    initscr();
+    if (this->headless) {
+        this->InitHeadless();
+    }
+    else {
+        initscr();
+    }
+
     nonl();
     cbreak();
     noecho();
@@ -297,6 +372,176 @@ void App::SetMouseEnabled(bool enabled) {
     this->mouseEnabled = enabled;
 }
 
+void App::SetHeadless(bool headless, int width, int height) {
+    this->headless = headless;
+    this->headlessWidth = std::max(1, width);
+    this->headlessHeight = std::max(1, height);
+}
+
+void App::SetInputRecorder(std::shared_ptr<InputRecorder> recorder) {
+    this->recorder = recorder;
+}
+
+void App::SetInputReplayer(std::shared_ptr<InputReplayer> replayer) {
+    this->replayer = replayer;
+}
+
+void App::SetLatencyTracing(bool enabled, const std::string& reportFilename) {
+    latency.SetEnabled(enabled);
+    this->latencyReportFilename = reportFilename;
+}
+
+LatencyTracker::Category App::CategorizeInput(
+    const std::string& kn, bool overlay, bool wroteToInput)
+{
+    if (overlay) {
+        return LatencyTracker::Overlay;
+    }
+    else if (wroteToInput) {
+        return LatencyTracker::TextInput;
+    }
+
+    auto& keys = Window::NavigationKeys();
+    KeyId id = key::Intern(kn);
+
+    if (id == key::Tab || id == key::BackTab ||
+        keys.Up(id) || keys.Down(id) || keys.Left(id) || keys.Right(id) ||
+        keys.PageUp(id) || keys.PageDown(id) || keys.Home(id) || keys.End(id) ||
+        keys.Next(id) || keys.Prev(id))
+    {
+        return LatencyTracker::Navigation;
+    }
+
+    return LatencyTracker::Other;
+}
+
+void App::SetRawInputEnabled(bool enabled) {
+    this->rawInputEnabled = enabled;
+}
+
+bool App::ReadRawInput(std::string& kn, MEVENT& mouseEvent) {
+    if (this->state.input) {
+        /* wgetch() would have done this for us: make sure the focused
+        input's cursor ends up on screen */
+        wrefresh(this->state.focused->GetContent());
+    }
+
+    RawInput::Event event;
+    if (!this->rawInput->Read(event, IDLE_TIMEOUT_MS)) {
+        return false;
+    }
+
+    switch (event.type) {
+        case RawInput::Event::Key:
+            kn = event.name;
+            return true;
+
+        case RawInput::Event::Mouse:
+            memset(&mouseEvent, 0, sizeof(mouseEvent));
+            mouseEvent.x = event.x;
+            mouseEvent.y = event.y;
+            mouseEvent.bstate = (mmask_t) event.state;
+            kn = "KEY_MOUSE";
+            return true;
+
+        case RawInput::Event::Paste:
+            if (this->recorder) {
+                this->recorder->RecordPaste(event.text);
+            }
+            this->Paste(event.text);
+            return false;
+    }
+
+    return false;
+}
+
+void App::Paste(const std::string& text) {
+    IInput* input = this->state.input;
+
+    if (!input || !this->state.focused->IsVisible()) {
+        return; /* nowhere sensible to put it */
+    }
+
+    int64_t inputAt = latency.IsEnabled() ? LatencyTracker::Now() : 0;
+
+    if (!input->Paste(text)) {
+        /* fall back to one character at a time */
+        size_t i = 0;
+        while (i < text.size()) {
+            size_t length = 1;
+            unsigned char c = (unsigned char) text[i];
+            if (c >= 0xf0) { length = 4; }
+            else if (c >= 0xe0) { length = 3; }
+            else if (c >= 0xc0) { length = 2; }
+            input->Write(text.substr(i, length));
+            i += length;
+        }
+    }
+
+    if (inputAt) {
+        latency.OnInput(
+            this->state.overlay ? LatencyTracker::Overlay : LatencyTracker::TextInput,
+            inputAt);
+    }
+}
+
+void App::ProcessResize(int width, int height) {
+    /* zero means "ask the terminal" */
+    resize_term(height, width);
+
+    Window::InvalidateScreen();
+
+    if (this->resizeHandler) {
+        this->resizeHandler();
+    }
+
+    this->OnResized();
+
+    if (this->recorder) {
+        this->recorder->RecordResize(Screen::GetWidth(), Screen::GetHeight());
+    }
+}
+
+bool App::ReadReplayedInput(std::string& kn, MEVENT& mouseEvent) {
+    InputReplayer::Event event;
+
+    while (this->replayer->Poll(event)) {
+        switch (event.type) {
+            case InputReplayer::Event::Key:
+                kn = event.key;
+                return true;
+
+            case InputReplayer::Event::Mouse:
+                memset(&mouseEvent, 0, sizeof(mouseEvent));
+                mouseEvent.x = event.x;
+                mouseEvent.y = event.y;
+                mouseEvent.bstate = (mmask_t) event.state;
+                kn = "KEY_MOUSE";
+                return true;
+
+            case InputReplayer::Event::Resize:
+                this->ProcessResize(event.width, event.height);
+                return false;
+
+            case InputReplayer::Event::Paste:
+                this->Paste(event.text);
+                return false;
+        }
+    }
+
+    /* nothing due yet. in real time mode, idle like wgetch() would have. */
+    if (this->replayer->GetSpeed() == InputReplayer::RealTime) {
+        int64_t delay = std::min(
+            (int64_t) IDLE_TIMEOUT_MS, this->replayer->NextEventDelay());
+
+        if (delay > 0) {
+            std::this_thread::sleep_for(milliseconds(delay));
+        }
+    }
+
+    return false;
+}
+
 #ifdef WIN32
 bool App::Running(const std::string& uniqueId) {
     return App::Running(uniqueId, uniqueId);
@@ -332,38 +577,95 @@ void App::Run(ILayoutPtr layout) {
     MEVENT mouseEvent;
     int64_t ch;
     std::string kn;
+    bool haveMouseEvent, haveRawInput, overlayActive, wroteToInput;
+    int64_t inputAt;
 
     this->state.input = nullptr;
     this->state.keyHandler = nullptr;
 
+    if (this->recorder && !this->recorder->IsRecording()) {
+        this->recorder->Start();
+    }
+
+    if (this->rawInputEnabled && !this->headless) {
+        this->rawInput.reset(new RawInput());
+        this->rawInput->Start(this->mouseEnabled);
+    }
+
+    if (this->replayer) {
+        auto replayer = this->replayer;
+        replayer->Start();
+        App::SetClock([replayer]() -> int64_t { return replayer->Now(); });
+    }
+
     this->ChangeLayout(layout);
 
     while (!this->quit && !disconnected) {
+        if (resized) {
+            resized = 0;
+            endwin(); /* required in *nix because? */
+            resizeAt = App::Now() + REDRAW_DEBOUNCE_MS;
+        }
+
         kn = "";
+        ch = ERR;
+        haveMouseEvent = false;
+        haveRawInput = false;
+        wroteToInput = false;
+        inputAt = 0;
 
         if (this->injectedKeys.size()) {
             kn = injectedKeys.front();
             injectedKeys.pop();
-            ch = ERR;
             goto process;
         }
 
-        timeout(IDLE_TIMEOUT_MS);
+        if (this->replayer) {
+            if (this->ReadReplayedInput(kn, mouseEvent)) {
+                haveMouseEvent = (kn == "KEY_MOUSE");
+                inputAt = latency.IsEnabled() ? LatencyTracker::Now() : 0;
 
-        if (this->state.input) {
-            /* if the focused window is an input, allow it to draw a cursor */
-            WINDOW *c = this->state.focused->GetContent();
-            keypad(c, TRUE);
-            wtimeout(c, IDLE_TIMEOUT_MS);
-            ch = wgetch(c);
+                /* keys are recorded before the hook sees them, so it gets to
+                see (and consume) them again here, just like it did live. */
+                if (this->keyHook && this->keyHook(kn)) {
+                    continue;
+                }
+
+                goto process;
+            }
+        }
+        else if (this->rawInput) {
+            haveRawInput = this->ReadRawInput(kn, mouseEvent);
+            haveMouseEvent = haveRawInput && (kn == "KEY_MOUSE");
         }
         else {
-            /* otherwise, no cursor */
-            ch = wgetch(stdscr);
+            timeout(IDLE_TIMEOUT_MS);
+
+            if (this->state.input) {
+                /* if the focused window is an input, allow it to draw a cursor */
+                WINDOW *c = this->state.focused->GetContent();
+                keypad(c, TRUE);
+                wtimeout(c, IDLE_TIMEOUT_MS);
+                ch = wgetch(c);
+            }
+            else {
+                /* otherwise, no cursor */
+                ch = wgetch(stdscr);
+            }
         }
 
-        if (ch != ERR) {
-            kn = key::Read((int) ch);
+        if (ch != ERR || haveRawInput) {
+            inputAt = latency.IsEnabled() ? LatencyTracker::Now() : 0;
+
+            if (!haveRawInput) {
+                kn = key::Read((int) ch);
+            }
+
+            /* mouse events are recorded once decoded, and resizes once they
+            have settled; see below. */
+            if (this->recorder && kn != "KEY_MOUSE" && kn != "KEY_RESIZE") {
+                this->recorder->RecordKey(kn);
+            }
 
             if (this->keyHook) {
                 if (this->keyHook(kn)) {
@@ -372,7 +674,9 @@ void App::Run(ILayoutPtr layout) {
             }
 
 process:
-            if (ch == '\t') { /* tab */
+            overlayActive = (this->state.overlay != nullptr);
+
+            if (ch == '\t' || kn == "^I") { /* tab */
                 this->FocusNextInLayout();
             }
             else if (kn == "KEY_BTAB") { /* shift-tab */
@@ -386,15 +690,20 @@ process:
             }
             else if (this->mouseEnabled && kn == "KEY_MOUSE") {
 #ifdef WIN32
-                if (nc_getmouse(&mouseEvent) == 0) {
+                if (haveMouseEvent || nc_getmouse(&mouseEvent) == 0) {
 #else
-                if (getmouse(&mouseEvent) == 0) {
+                if (haveMouseEvent || getmouse(&mouseEvent) == 0) {
 #endif
+                    if (this->recorder && (ch != ERR || haveRawInput)) {
+                        this->recorder->RecordMouse(
+                            mouseEvent.x, mouseEvent.y, (int64_t) mouseEvent.bstate);
+                    }
+
                     auto active = this->state.ActiveLayout();
                     if (active) {
                         using Event = IMouseHandler::Event;
-                        auto window = dynamic_cast<IWindow*>(active.get());
-                        Event event(mouseEvent, window);
+                        /* resolved when the layout/overlay changed, not per event */
+                        Event event(mouseEvent, this->state.ActiveWindow());
                         if (event.MouseWheelDown() || event.MouseWheelUp()) {
                             if (state.focused) {
                                 state.focused->MouseEvent(event);
@@ -406,32 +715,45 @@ process:
                     }
                 }
             }
-            /* order: focused input, global key handler, then layout. */
+            /* a pending chord takes precedence, even over a focused input */
+            else if (Window::Keymaps().IsChordPending() &&
+                Window::Keymaps().Dispatch(
+                    key::Intern(kn), this->state.focused.get(), this->state.ActiveWindow()))
+            {
+                /* consumed by the chord */
+            }
+            /* order: focused input, keymaps, global key handler, then layout. */
             else if (!this->state.input ||
                 !this->state.focused->IsVisible() ||
                 !this->state.input->Write(kn))
             {
-                if (!keyHandler || !keyHandler(kn)) {
-                    if (!this->state.keyHandler || !this->state.keyHandler->KeyPress(kn)) {
-                        this->state.ActiveLayout()->KeyPress(kn);
+                /* intern once; keymaps and handlers dispatch on the id */
+                KeyId id = key::Intern(kn);
+                auto& keymaps = Window::Keymaps();
+                if (!keymaps.Dispatch(id, this->state.focused.get(), this->state.ActiveWindow())) {
+                    if (!keyHandler || !keyHandler(kn)) {
+                        if (!this->state.keyHandler || !this->state.keyHandler->KeyPress(id)) {
+                            this->state.ActiveLayout()->KeyPress(id);
+                        }
                     }
                 }
             }
+            else {
+                wroteToInput = true;
+            }
+
+            /* resizes are debounced, so they have no meaningful latency */
+            if (inputAt && kn != "KEY_RESIZE") {
+                latency.OnInput(
+                    this->CategorizeInput(kn, overlayActive, wroteToInput),
+                    inputAt);
+            }
         }
 
         /* KEY_RESIZE often gets called dozens of times, so we debounce the
         actual resize until its settled. */
         if (resizeAt && App::Now() > resizeAt) {
-            resize_term(0, 0);
-
-            Window::InvalidateScreen();
-
-            if (this->resizeHandler) {
-                this->resizeHandler();
-            }
-
-            this->OnResized();
-
+            this->ProcessResize(0, 0);
             resizeAt = 0;
         }
 
@@ -450,9 +772,35 @@ process:
         }
 
         /* always last to avoid flicker. see above. */
-        Window::WriteToScreen(this->state.input);
+        if (Window::WriteToScreen(this->state.input)) {
+            if (latency.IsEnabled()) {
+                latency.OnFrame(LatencyTracker::Now());
+            }
+
+            if (this->replayer) {
+                this->replayer->OnFrameWritten();
+            }
+        }
+
+        if (this->replayer && this->replayer->Finished()) {
+            this->quit = true;
+        }
+    }
+
+    if (this->replayer) {
+        App::SetClock(Clock());
+    }
+
+    if (this->recorder) {
+        this->recorder->Stop();
     }
 
+    if (this->rawInput) {
+        this->rawInput->Stop();
+        this->rawInput.reset();
+    }
+
+    notifications.Reset();
     overlays.Clear();
 }
 
@@ -483,6 +831,40 @@ OverlayStack& App::Overlays() {
     return overlays;
 }
 
+LatencyTracker& App::Latency() {
+    return latency;
+}
+
+NotificationCenter& App::Notifications() {
+    return notifications;
+}
+
+void App::RunInBackground(std::function<void()> task) {
+    /* reap the ones that are already done, so the list stays short */
+    auto it = backgroundThreads.begin();
+    while (it != backgroundThreads.end()) {
+        if (it->done->load()) {
+            it->thread.join();
+            it = backgroundThreads.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    auto done = std::make_shared<std::atomic<bool>>(false);
+    std::thread thread([task, done] {
+        task();
+        done->store(true);
+    });
+
+    backgroundThreads.push_back({ std::move(thread), done });
+}
+
+void App::SetOverlaysPreserveLayout(bool preserve) {
+    this->overlaysPreserveLayout = preserve;
+}
+
 void App::CheckShowOverlay() {
     ILayoutPtr top = overlays.Top();
 
@@ -490,6 +872,12 @@ void App::CheckShowOverlay() {
         if (this->state.overlay) {
             this->state.overlay->Hide();
         }
+        else if (this->overlaysPreserveLayout) {
+            /* the first overlay is going up; remember what to go back to */
+            this->focusBeforeOverlay = this->state.focused;
+            this->widthBeforeOverlay = Screen::GetWidth();
+            this->heightBeforeOverlay = Screen::GetHeight();
+        }
 
         this->state.overlay = top;
 
@@ -497,7 +885,31 @@ void App::CheckShowOverlay() {
             top ? dynamic_cast<IWindow*>(top.get()) : nullptr;
 
         ILayoutPtr newTopLayout = this->state.ActiveLayout();
-        if (newTopLayout) {
+        if (!newTopLayout) {
+            return;
+        }
+
+        if (!top && this->overlaysPreserveLayout) {
+            /* the main layout's panels were never touched, so unless the
+            screen changed size underneath the overlay there's nothing to lay
+            out; just hand focus back. */
+            if (Screen::GetWidth() != this->widthBeforeOverlay ||
+                Screen::GetHeight() != this->heightBeforeOverlay)
+            {
+                newTopLayout->Layout();
+                newTopLayout->BringToTop();
+            }
+
+            IWindowPtr focus = this->focusBeforeOverlay;
+            this->focusBeforeOverlay.reset();
+
+            if (!focus || !newTopLayout->SetFocus(focus)) {
+                focus = newTopLayout->FocusFirst();
+            }
+
+            this->UpdateFocusedWindow(focus);
+        }
+        else {
             newTopLayout->Layout();
             newTopLayout->Show();
             newTopLayout->BringToTop();
@@ -556,7 +968,15 @@ void App::FocusPrevInLayout() {
     this->UpdateFocusedWindow(this->state.ActiveLayout()->FocusPrev());
 }
 
+void App::SetClock(Clock clock) {
+    virtualClock = clock;
+}
+
 int64_t App::Now() {
+    if (virtualClock) {
+        return virtualClock();
+    }
+
     return duration_cast<milliseconds>(
         system_clock::now().time_since_epoch()).count();
 }
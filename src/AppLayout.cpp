@@ -207,12 +207,12 @@ void AppLayout::FocusShortcuts() {
     this->shortcuts->Focus();
 }
 
-bool AppLayout::KeyPress(const std::string& key) {
+bool AppLayout::KeyPress(KeyId key) {
     /* otherwise, see if the user is monkeying around with the
     shortcut bar focus... */
-    if (key == "^["  ||
-        (key == "KEY_ENTER" && this->shortcutsFocused) ||
-        (key == "KEY_UP" && this->shortcutsFocused))
+    if (key == key::Escape  ||
+        (key == key::Enter && this->shortcutsFocused) ||
+        (key == key::Up && this->shortcutsFocused))
     {
         this->shortcutsFocused = !this->shortcutsFocused;
         if (this->shortcutsFocused) {
@@ -225,8 +225,8 @@ bool AppLayout::KeyPress(const std::string& key) {
     }
 
     if (this->shortcutsFocused) {
-        if (key == "KEY_DOWN" || key == "KEY_LEFT" ||
-            key == "KEY_UP" || key == "KEY_RIGHT")
+        if (key == key::Down || key == key::Left ||
+            key == key::Up || key == key::Right)
         {
             /* layouts allow focusing via TAB and sometimes arrow
             keys. suppress these from bubbling. */
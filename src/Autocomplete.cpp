@@ -0,0 +1,296 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <cursespp/Autocomplete.h>
+#include <cursespp/TextInput.h>
+#include <cursespp/ListWindow.h>
+#include <cursespp/SimpleScrollAdapter.h>
+#include <cursespp/Screen.h>
+#include <f8n/runtime/Message.h>
+#include <f8n/str/utf.h>
+#include <algorithm>
+
+using namespace cursespp;
+using namespace f8n::runtime;
+using namespace f8n::utf;
+
+#define MESSAGE_SUGGESTIONS_READY 1
+#define MAX_VISIBLE_ROWS 8
+
+const size_t Autocomplete::DEFAULT_LIMIT;
+
+Autocomplete::Autocomplete(
+    TextInput* input,
+    IAutocompleteProviderPtr provider,
+    size_t limit)
+: input(input)
+, provider(provider)
+, limit(limit)
+, minimumLength(1)
+, accepting(false)
+, requested(0)
+, completed(0)
+, pending(false)
+, quit(false) {
+    this->input->TextChanged.connect(this, &Autocomplete::OnTextChanged);
+}
+
+Autocomplete::~Autocomplete() {
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->quit = true;
+        if (this->cancelled) {
+            this->cancelled->store(true);
+        }
+    }
+
+    this->condition.notify_all();
+
+    if (this->thread.joinable()) {
+        this->thread.join();
+    }
+
+    /* the worker is gone, so nothing else can be posted */
+    Window::MessageQueue().Remove(this);
+
+    this->Hide();
+}
+
+void Autocomplete::SetMinimumLength(size_t length) {
+    this->minimumLength = length;
+}
+
+bool Autocomplete::IsVisible() {
+    return this->dropdown && this->dropdown->IsVisible();
+}
+
+void Autocomplete::Hide() {
+    if (this->IsVisible()) {
+        this->dropdown->Hide();
+    }
+}
+
+bool Autocomplete::KeyPress(KeyId key) {
+    if (!this->IsVisible()) {
+        return false;
+    }
+
+    if (key == key::Up) {
+        this->dropdown->ScrollUp();
+        return true;
+    }
+    else if (key == key::Down) {
+        this->dropdown->ScrollDown();
+        return true;
+    }
+    else if (key == key::Enter) {
+        this->Accept(this->dropdown->GetSelectedIndex());
+        return true;
+    }
+    else if (key == key::Escape) {
+        this->Cancel();
+        this->Hide();
+        return true;
+    }
+
+    return false;
+}
+
+void Autocomplete::OnTextChanged(TextInput* input, std::string text) {
+    if (!this->accepting) {
+        this->Query(text);
+    }
+}
+
+void Autocomplete::Query(const std::string& text) {
+    if (u8len(text) < this->minimumLength) {
+        this->Cancel();
+        this->Hide();
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+
+        if (this->cancelled) {
+            this->cancelled->store(true);
+        }
+
+        this->cancelled = std::make_shared<std::atomic<bool>>(false);
+        this->query = text;
+        this->pending = true;
+        ++this->requested;
+
+        /* started on first use, so inputs that never get typed into don't
+        cost a thread */
+        if (!this->thread.joinable()) {
+            this->thread = std::thread(&Autocomplete::ThreadProc, this);
+        }
+    }
+
+    this->condition.notify_one();
+}
+
+void Autocomplete::Cancel() {
+    std::unique_lock<std::mutex> lock(this->mutex);
+
+    if (this->cancelled) {
+        this->cancelled->store(true);
+    }
+
+    this->pending = false;
+    ++this->requested; /* anything in flight is now stale */
+}
+
+void Autocomplete::ThreadProc() {
+    IAutocompleteProvider::Suggestions found;
+
+    while (true) {
+        std::string query;
+        std::shared_ptr<std::atomic<bool>> cancelled;
+        uint64_t id;
+
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+
+            this->condition.wait(lock, [this] {
+                return this->quit || this->pending;
+            });
+
+            if (this->quit) {
+                return;
+            }
+
+            query = this->query;
+            cancelled = this->cancelled;
+            id = this->requested;
+            this->pending = false;
+        }
+
+        this->provider->Suggest(query, this->limit, *cancelled, found);
+
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+
+            if (this->quit) {
+                return;
+            }
+
+            if (cancelled->load() || id != this->requested) {
+                continue; /* superseded while we were working */
+            }
+
+            this->results.swap(found);
+            this->completed = id;
+        }
+
+        Window::MessageQueue().Post(
+            Message::Create(this, MESSAGE_SUGGESTIONS_READY, 0, 0));
+    }
+}
+
+void Autocomplete::ProcessMessage(IMessage& message) {
+    if (message.Type() == MESSAGE_SUGGESTIONS_READY) {
+        IAutocompleteProvider::Suggestions suggestions;
+
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            if (this->completed != this->requested) {
+                return; /* the user kept typing; newer results are coming */
+            }
+            suggestions.swap(this->results);
+        }
+
+        if (this->input->IsFocused()) {
+            this->Show(suggestions);
+        }
+    }
+}
+
+void Autocomplete::Show(IAutocompleteProvider::Suggestions& suggestions) {
+    if (suggestions.empty()) {
+        this->Hide();
+        return;
+    }
+
+    if (!this->dropdown) {
+        this->adapter = std::make_shared<SimpleScrollAdapter>();
+        this->adapter->SetSelectable(true);
+        this->dropdown = std::make_shared<ListWindow>(this->adapter);
+        this->dropdown->EntryActivated.connect(this, &Autocomplete::OnEntryActivated);
+    }
+
+    this->shown.swap(suggestions);
+    this->adapter->Clear();
+    for (auto& suggestion : this->shown) {
+        this->adapter->AddEntry(suggestion.value);
+    }
+
+    /* directly under the input if there's room, otherwise above it */
+    int rows = std::min((int) this->shown.size(), MAX_VISIBLE_ROWS);
+    int height = rows + 2;
+    int width = this->input->GetWidth();
+    int x = this->input->GetAbsoluteX();
+    int y = this->input->GetAbsoluteY() + this->input->GetHeight();
+
+    if (y + height > Screen::GetHeight()) {
+        y = std::max(0, this->input->GetAbsoluteY() - height);
+    }
+
+    this->dropdown->MoveAndResize(x, y, width, height);
+    this->dropdown->Show();
+    this->dropdown->BringToTop();
+    this->dropdown->ScrollToTop();
+}
+
+void Autocomplete::Accept(size_t index) {
+    if (index >= this->shown.size()) {
+        return;
+    }
+
+    std::string value = this->shown[index].value;
+
+    this->Cancel();
+    this->Hide();
+
+    this->accepting = true;
+    this->input->Replace(value); /* undoable */
+    this->accepting = false;
+
+    this->SuggestionAccepted(this, value);
+}
+
+void Autocomplete::OnEntryActivated(ListWindow* sender, size_t index) {
+    this->Accept(index);
+}
@@ -85,8 +85,8 @@ void Checkbox::SetChecked(bool checked) {
     }
 }
 
-bool Checkbox::KeyPress(const std::string& key) {
-    if (key == " " || key == "KEY_ENTER") {
+bool Checkbox::KeyPress(KeyId key) {
+    if (key == key::Space || key == key::Enter) {
         this->SetChecked(!this->checked);
         return true;
     }
@@ -0,0 +1,165 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <cursespp/ColorPairAllocator.h>
+#include <algorithm>
+
+using namespace cursespp;
+
+#define NO_SLOT -1
+
+ColorPairAllocator::ColorPairAllocator()
+: first(0)
+, used(0)
+, head(NO_SLOT)
+, tail(NO_SLOT)
+, themeBackground(-1) {
+}
+
+void ColorPairAllocator::SetRange(int first, int last) {
+    this->first = first;
+    this->slots.resize((size_t) std::max(0, last - first));
+    this->Clear();
+}
+
+uint64_t ColorPairAllocator::Key(int foreground, int background) {
+    return ((uint64_t) (uint32_t) foreground << 32) | (uint32_t) background;
+}
+
+int ColorPairAllocator::Acquire(int foreground, int background) {
+    auto key = Key(foreground, background);
+    auto it = this->pairs.find(key);
+
+    if (it != this->pairs.end()) {
+        int slot = it->second;
+        if (slot != this->head) {
+            this->Unlink(slot);
+            this->PushFront(slot);
+        }
+        return this->first + slot;
+    }
+
+    if (this->slots.empty()) {
+        return 0;
+    }
+
+    int slot;
+    if (this->used < (int) this->slots.size()) {
+        slot = this->used++;
+    }
+    else {
+        slot = this->tail;
+        this->Unlink(slot);
+        auto& evicted = this->slots[slot];
+        this->pairs.erase(Key(evicted.foreground, evicted.background));
+    }
+
+    auto& entry = this->slots[slot];
+    entry.foreground = foreground;
+    entry.background = background;
+    this->PushFront(slot);
+    this->pairs[key] = slot;
+
+    this->Define(this->first + slot, foreground, background);
+    return this->first + slot;
+}
+
+void ColorPairAllocator::Rebuild(int themeBackground) {
+    this->themeBackground = themeBackground;
+    for (int i = 0; i < this->used; i++) {
+        auto& slot = this->slots[i];
+        this->Define(this->first + i, slot.foreground, slot.background);
+    }
+}
+
+void ColorPairAllocator::Clear() {
+    this->pairs.clear();
+    this->used = 0;
+    this->head = this->tail = NO_SLOT;
+}
+
+size_t ColorPairAllocator::Size() const {
+    return (size_t) this->used;
+}
+
+size_t ColorPairAllocator::Capacity() const {
+    return this->slots.size();
+}
+
+void ColorPairAllocator::Define(int pair, int foreground, int background) {
+    if (background == ThemeBackground) {
+        background = this->themeBackground;
+    }
+#ifdef CURSESPP_EXTENDED_COLORS
+    init_extended_pair(pair, foreground, background);
+#else
+    init_pair((short) pair, (short) foreground, (short) background);
+#endif
+}
+
+void ColorPairAllocator::Unlink(int slot) {
+    auto& entry = this->slots[slot];
+
+    if (entry.prev != NO_SLOT) {
+        this->slots[entry.prev].next = entry.next;
+    }
+    else {
+        this->head = entry.next;
+    }
+
+    if (entry.next != NO_SLOT) {
+        this->slots[entry.next].prev = entry.prev;
+    }
+    else {
+        this->tail = entry.prev;
+    }
+
+    entry.prev = entry.next = NO_SLOT;
+}
+
+void ColorPairAllocator::PushFront(int slot) {
+    auto& entry = this->slots[slot];
+    entry.prev = NO_SLOT;
+    entry.next = this->head;
+
+    if (this->head != NO_SLOT) {
+        this->slots[this->head].prev = slot;
+    }
+
+    this->head = slot;
+
+    if (this->tail == NO_SLOT) {
+        this->tail = slot;
+    }
+}
@@ -34,12 +34,31 @@
 
 #include <json.hpp>
 #include <cursespp/Colors.h>
+#include <cursespp/ColorPairAllocator.h>
+#include <cursespp/Window.h>
 #include <f8n/environment/Environment.h>
 #include <f8n/environment/Filesystem.h>
+#include <f8n/runtime/Message.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
 
 using namespace cursespp;
 using namespace nlohmann;
 using namespace f8n::env;
+using namespace f8n::runtime;
 
 /* if the terminal supports custom colors, these are the palette
 indicies we'll use to store them */
@@ -127,6 +146,22 @@ used as key names in the config files */
 
 #define JSON_CURRENT_SCHEMA_VERSION 1
 
+/* compiled themes are cached here (in the data directory) so we don't have
+to parse every json file on startup. bump the version if the layout, or the
+set of colors in a theme, changes. */
+#define THEME_CACHE_FILENAME "themes.cache"
+#define THEME_CACHE_MAGIC 0x43545343
+#define THEME_CACHE_VERSION 2
+#define THEME_CACHE_MAX_STRING 4096
+
+#define MESSAGE_THEMES_INDEXED 1
+#define MESSAGE_THEME_FILE_CHANGED 2
+
+/* how often the watcher thread checks whether it should exit, and how long
+to wait for a burst of writes to a theme file to settle */
+#define THEME_WATCH_POLL_MS 250
+#define THEME_WATCH_DEBOUNCE_MS 100
+
 /* if we can't set custom colors, but we have the full 256 color
 palette, use ones that most closely match our desired colors */
 #define COLOR_256_GREEN 148
@@ -140,6 +175,93 @@ palette, use ones that most closely match our desired colors */
 
 #define SCALE(x) ((x * 1000) / 255)
 
+/* pairs above the fixed ones Theme uses are handed out on demand. the
+upper bound is what COLOR_PAIR() can carry in an attribute. */
+#define FIRST_DYNAMIC_PAIR (Color::Footer + 1)
+#define MAX_ATTRIBUTE_PAIRS 256
+
+static ColorPairAllocator colorPairs;
+
+/* what has been handed to curses for each fixed pair and custom color, so
+re-applying a theme (e.g. after its file was edited) only touches the
+slots that actually changed. invalidated whenever start_color() is called. */
+struct AppliedSlot {
+    int a, b, c;
+    bool valid;
+};
+
+static AppliedSlot appliedPairs[FIRST_DYNAMIC_PAIR];
+static AppliedSlot appliedColors[THEME_COLOR_FOOTER_FOREGROUND + 1];
+static AppliedSlot appliedBackground;
+static size_t changedSlots = 0;
+
+static bool updateSlot(AppliedSlot& slot, int a, int b, int c) {
+    if (slot.valid && slot.a == a && slot.b == b && slot.c == c) {
+        return false;
+    }
+    slot.a = a;
+    slot.b = b;
+    slot.c = c;
+    slot.valid = true;
+    ++changedSlots;
+    return true;
+}
+
+static void resetAppliedSlots() {
+    for (auto& slot : appliedPairs) { slot.valid = false; }
+    for (auto& slot : appliedColors) { slot.valid = false; }
+    appliedBackground.valid = false;
+}
+
+/* pairs may reference 24-bit color numbers, which don't fit in a short */
+static void initPair(int pair, int foreground, int background) {
+    if (!updateSlot(appliedPairs[pair], foreground, background, 0)) {
+        return;
+    }
+#ifdef CURSESPP_EXTENDED_COLORS
+    init_extended_pair(pair, foreground, background);
+#else
+    init_pair((short) pair, (short) foreground, (short) background);
+#endif
+}
+
+static void initColor(int id, int r, int g, int b) {
+    if (updateSlot(appliedColors[id], r, g, b)) {
+        init_color(id, SCALE(r), SCALE(g), SCALE(b));
+    }
+}
+
+/* in direct color mode color numbers are 0xRRGGBB, except for the first
+8, which are still the terminal's ANSI colors. rgb values that land there
+(near-black blues) are nudged to 8, the closest color that isn't. */
+static int directColor(int r, int g, int b) {
+    return std::max(8, (r << 16) | (g << 8) | b);
+}
+
+/* the standard xterm values for the 256 color palette, so palette-only
+theme colors can still be used in direct color mode. */
+static int paletteToDirect(int index) {
+    static const int ansi[] = {
+        0x000000, 0x800000, 0x008000, 0x808000, 0x000080, 0x800080, 0x008080, 0xc0c0c0,
+        0x808080, 0xff0000, 0x00ff00, 0xffff00, 0x5c5cff, 0xff00ff, 0x00ffff, 0xffffff
+    };
+
+    if (index < 8) {
+        return index;
+    }
+    else if (index < 16) {
+        return ansi[index];
+    }
+    else if (index < 232) {
+        static const int levels[] = { 0, 95, 135, 175, 215, 255 };
+        index -= 16;
+        return directColor(levels[index / 36], levels[(index / 6) % 6], levels[index % 6]);
+    }
+
+    int gray = 8 + (index - 232) * 10;
+    return directColor(gray, gray, gray);
+}
+
 struct ThemeColor {
     ThemeColor() {
         Set(0, 0, 0, 0, -1);
@@ -181,12 +303,21 @@ struct ThemeColor {
         if (mode == Colors::Basic) {
             return defaultValue;
         }
+        else if (mode == Colors::DirectRGB) {
+            if (this->r >= 0 && this->g >= 0 && this->b >= 0) {
+                return directColor(this->r, this->g, this->b);
+            }
+            else if (this->palette >= 0 && this->palette < 256) {
+                return paletteToDirect(this->palette);
+            }
+            return defaultValue;
+        }
         else if (mode == Colors::Palette) {
             return this->palette;
         }
         else {
             if (this->colorId > 15 && this->r >= 0 && this->g >= 0 && this->b >= 0) {
-                init_color(this->colorId, SCALE(this->r), SCALE(this->g), SCALE(this->b));
+                initColor(this->colorId, this->r, this->g, this->b);
                 return this->colorId;
             }
             else {
@@ -203,6 +334,30 @@ struct ThemeColor {
     int palette;
 };
 
+template <typename T>
+static void writeValue(std::ostream& out, T value) {
+    out.write((const char*) &value, sizeof(T));
+}
+
+static void writeString(std::ostream& out, const std::string& value) {
+    writeValue<uint32_t>(out, (uint32_t) value.size());
+    out.write(value.data(), value.size());
+}
+
+template <typename T>
+static bool readValue(std::istream& in, T& value) {
+    return !!in.read((char*) &value, sizeof(T));
+}
+
+static bool readString(std::istream& in, std::string& value) {
+    uint32_t length = 0;
+    if (!readValue(in, length) || length > THEME_CACHE_MAX_STRING) {
+        return false;
+    }
+    value.resize(length);
+    return length == 0 || !!in.read(&value[0], length);
+}
+
 struct Theme {
     Theme() {
         this->name = "default";
@@ -335,9 +490,67 @@ struct Theme {
         return success;
     }
 
+    /* every color, in a fixed order. used to read and write the cache */
+    std::vector<ThemeColor*> AllColors() {
+        return {
+            &background, &foreground, &focusedBorder,
+            &textFocused, &textActive, &textDisabled, &textHidden, &textWarning, &textError,
+            &overlayBackground, &overlayForeground, &overlayBorder, &overlayFocusedBorder, &overlayFocusedText,
+            &shortcutsBackground, &shortcutsForeground, &focusedShortcutsBackground, &focusedShortcutsForeground,
+            &buttonBackgroundNormal, &buttonForegroundNormal, &buttonBackgroundActive, &buttonForegroundActive,
+            &bannerBackground, &bannerForeground,
+            &footerBackground, &footerForeground,
+            &listHeaderBackground, &listHeaderForeground,
+            &listHeaderHighlightedBackground, &listHeaderHighlightedForeground,
+            &listHighlightedBackground, &listHighlightedForeground,
+            &listActiveForeground, &listActiveBackground,
+            &listActiveHighlightedBackground, &listActiveHighlightedForeground
+        };
+    }
+
+    void Write(std::ostream& out) {
+        writeString(out, this->fn);
+        writeString(out, this->name);
+        auto colors = this->AllColors();
+        writeValue<uint32_t>(out, (uint32_t) colors.size());
+        for (auto color : colors) {
+            writeValue<int32_t>(out, color->r);
+            writeValue<int32_t>(out, color->g);
+            writeValue<int32_t>(out, color->b);
+            writeValue<int32_t>(out, color->palette);
+        }
+    }
+
+    bool Read(std::istream& in) {
+        uint32_t count = 0;
+        auto colors = this->AllColors();
+
+        if (!readString(in, this->fn) ||
+            !readString(in, this->name) ||
+            !readValue(in, count) ||
+            count != colors.size())
+        {
+            return false;
+        }
+
+        for (auto color : colors) {
+            int32_t r, g, b, palette;
+            if (!readValue(in, r) || !readValue(in, g) ||
+                !readValue(in, b) || !readValue(in, palette))
+            {
+                return false;
+            }
+            color->Set(color->colorId, r, g, b, palette);
+        }
+
+        return true;
+    }
+
     /* initializes all of the color pairs from the specified colors, then applies them
-    to the current session! */
-    void Apply(Colors::Mode mode, Colors::BgType bgType) {
+    to the current session! returns true if anything actually changed. */
+    bool Apply(Colors::Mode mode, Colors::BgType bgType) {
+        size_t changed = changedSlots;
+
 #ifdef WIN32
         bgType = Colors::Theme;
 #endif
@@ -345,92 +558,98 @@ struct Theme {
         int foregroundId = foreground.Id(mode, -1);
 
         /* main */
-        init_pair(Color::ContentColorDefault, foregroundId, backgroundId);
-        init_pair(Color::FrameColorDefault, foregroundId, backgroundId);
-        init_pair(Color::FrameColorFocused, focusedBorder.Id(mode, COLOR_RED),backgroundId);
+        initPair(Color::ContentColorDefault, foregroundId, backgroundId);
+        initPair(Color::FrameColorDefault, foregroundId, backgroundId);
+        initPair(Color::FrameColorFocused, focusedBorder.Id(mode, COLOR_RED),backgroundId);
 
         /* text */
-        init_pair(Color::TextDefault, foregroundId, backgroundId);
-        init_pair(Color::TextDisabled, textDisabled.Id(mode, -1), backgroundId);
-        init_pair(Color::TextFocused, textFocused.Id(mode, COLOR_RED), backgroundId);
-        init_pair(Color::TextActive, textActive.Id(mode, COLOR_GREEN), backgroundId);
-        init_pair(Color::TextWarning, textWarning.Id(mode, COLOR_YELLOW), backgroundId);
-        init_pair(Color::TextError, textError.Id(mode, COLOR_RED), backgroundId);
-        init_pair(Color::TextHidden, textHidden.Id(mode, COLOR_BLACK), backgroundId);
+        initPair(Color::TextDefault, foregroundId, backgroundId);
+        initPair(Color::TextDisabled, textDisabled.Id(mode, -1), backgroundId);
+        initPair(Color::TextFocused, textFocused.Id(mode, COLOR_RED), backgroundId);
+        initPair(Color::TextActive, textActive.Id(mode, COLOR_GREEN), backgroundId);
+        initPair(Color::TextWarning, textWarning.Id(mode, COLOR_YELLOW), backgroundId);
+        initPair(Color::TextError, textError.Id(mode, COLOR_RED), backgroundId);
+        initPair(Color::TextHidden, textHidden.Id(mode, COLOR_BLACK), backgroundId);
 
         /* overlay */
         int overlayBgId = overlayBackground.Id(mode, -1);
-        init_pair(Color::OverlayFrame, overlayBorder.Id(mode, COLOR_BLUE), overlayBgId);
-        init_pair(Color::OverlayContent, overlayForeground.Id(mode, -1), overlayBgId);
-        init_pair(Color::OverlayTextInputFrame, overlayFocusedBorder.Id(mode, COLOR_RED), overlayBgId);
-        init_pair(Color::OverlayTextFocused, overlayFocusedText.Id(mode, COLOR_RED), overlayBgId);
-        init_pair(Color::OverlayListFrame, foregroundId, overlayBgId);
-        init_pair(Color::OverlayListFrameFocused, focusedBorder.Id(mode, COLOR_RED), overlayBgId);
+        initPair(Color::OverlayFrame, overlayBorder.Id(mode, COLOR_BLUE), overlayBgId);
+        initPair(Color::OverlayContent, overlayForeground.Id(mode, -1), overlayBgId);
+        initPair(Color::OverlayTextInputFrame, overlayFocusedBorder.Id(mode, COLOR_RED), overlayBgId);
+        initPair(Color::OverlayTextFocused, overlayFocusedText.Id(mode, COLOR_RED), overlayBgId);
+        initPair(Color::OverlayListFrame, foregroundId, overlayBgId);
+        initPair(Color::OverlayListFrameFocused, focusedBorder.Id(mode, COLOR_RED), overlayBgId);
 
         /* shortcuts */
-        init_pair(
+        initPair(
             Color::ShortcutRowDefault,
             shortcutsForeground.Id(mode, COLOR_YELLOW),
             shortcutsBackground.Id(mode, -1));
 
-        init_pair(
+        initPair(
             Color::ShortcutRowFocused,
             focusedShortcutsForeground.Id(mode, COLOR_WHITE),
             focusedShortcutsBackground.Id(mode, COLOR_RED));
 
         /* buttons */
-        init_pair(
+        initPair(
             Color::ButtonDefault,
             buttonForegroundNormal.Id(mode, COLOR_BLACK),
             buttonBackgroundNormal.Id(mode, COLOR_YELLOW));
 
-        init_pair(
+        initPair(
             Color::ButtonHighlighted,
             buttonForegroundActive.Id(mode, COLOR_BLACK),
             buttonBackgroundActive.Id(mode, COLOR_GREEN));
 
         /* banner */
-        init_pair(
+        initPair(
             Color::Banner,
             bannerForeground.Id(mode, COLOR_BLACK),
             bannerBackground.Id(mode, COLOR_YELLOW));
 
         /* footer */
-        init_pair(
+        initPair(
             Color::Footer,
             footerForeground.Id(mode, COLOR_BLACK),
             footerBackground.Id(mode, COLOR_BLUE));
 
         /* list items */
-        init_pair(
+        initPair(
             Color::ListItemHeader,
             listHeaderForeground.Id(mode, COLOR_GREEN),
             listHeaderBackground.Id(mode, -1));
 
-        init_pair(
+        initPair(
             Color::ListItemHeaderHighlighted,
             listHeaderHighlightedForeground.Id(mode, -1),
             listHeaderHighlightedBackground.Id(mode, COLOR_GREEN));
 
-        init_pair(
+        initPair(
             Color::ListItemSelected,
             listActiveForeground.Id(mode, COLOR_YELLOW),
             listActiveBackground.Id(mode, COLOR_BLACK));
 
-        init_pair(
+        initPair(
             Color::ListItemHighlighted,
             listHighlightedForeground.Id(mode, COLOR_BLACK),
             listHighlightedBackground.Id(mode, COLOR_GREEN));
 
-        init_pair(
+        initPair(
             Color::ListItemHighlightedSelected,
             listActiveHighlightedForeground.Id(mode, COLOR_BLACK),
             listActiveHighlightedBackground.Id(mode, COLOR_YELLOW));
 
-        init_pair(
+        initPair(
             Color::ListItemError,
             textError.Id(mode, COLOR_RED),
             listHighlightedBackground.Id(mode, COLOR_GREEN));
+
+        if (updateSlot(appliedBackground, backgroundId, 0, 0)) {
+            colorPairs.Rebuild(backgroundId);
+        }
+
+        return changedSlots != changed;
     }
 
     std::string name;
@@ -507,49 +726,452 @@ static bool canChangeColors() {
 #endif
 }
 
+/* direct color terminfo entries advertise the "RGB" capability, and more
+colors than fit in a palette. the color numbers only fit in the extended
+color api, so there's no point without it. */
+static bool supportsDirectColor() {
+#ifdef CURSESPP_EXTENDED_COLORS
+    return tigetflag((char*) "RGB") > 0 || COLORS >= 0x1000000;
+#else
+    return false;
+#endif
+}
+
 Colors::Colors() {
 }
 
-static std::string lastTheme = "default";
-static Theme theme;
-static std::vector<Theme> themes;
-static Colors::Mode colorMode = Colors::Basic;
-static Colors::BgType bgType = Colors::Theme;
+/* an indexed theme file, and the size and modification time it had when it
+was compiled; if either changes, the file is parsed again. files that failed
+to parse are cached too (with just their filename), so they aren't retried
+on every start. */
+struct ThemeFile {
+    Theme theme;
+    int64_t mtime, size;
+    bool loaded{ true };
+};
+
+static bool statFile(const std::string& fn, int64_t& mtime, int64_t& size) {
+    struct stat info;
+    if (stat(fn.c_str(), &info) != 0) {
+        return false;
+    }
+    mtime = (int64_t) info.st_mtime;
+    size = (int64_t) info.st_size;
+    return true;
+}
+
+static std::string cacheFilename() {
+    return f8n::env::GetDataDirectory() + "/" + THEME_CACHE_FILENAME;
+}
+
+static void readCache(std::map<std::string, ThemeFile>& target) {
+    std::ifstream in(cacheFilename(), std::ios::binary);
+    uint32_t magic = 0, version = 0, count = 0;
+
+    if (!in.is_open() ||
+        !readValue(in, magic) || magic != THEME_CACHE_MAGIC ||
+        !readValue(in, version) || version != THEME_CACHE_VERSION ||
+        !readValue(in, count))
+    {
+        return;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        ThemeFile file;
+        uint8_t loaded = 0;
+        if (!readValue(in, loaded) ||
+            !(loaded ? file.theme.Read(in) : readString(in, file.theme.fn)) ||
+            !readValue(in, file.mtime) ||
+            !readValue(in, file.size))
+        {
+            target.clear(); /* truncated or corrupt; start over */
+            return;
+        }
+        file.loaded = !!loaded;
+        target[file.theme.fn] = file;
+    }
+}
+
+static void writeCache(std::vector<ThemeFile>& files, std::vector<ThemeFile>& failed) {
+    std::string fn = cacheFilename();
+    std::string temp = fn + ".tmp";
+
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            return;
+        }
+
+        uint32_t count = (uint32_t) failed.size();
+        for (auto& file : files) {
+            count += file.theme.fn.size() ? 1 : 0; /* the default isn't a file */
+        }
+
+        writeValue<uint32_t>(out, THEME_CACHE_MAGIC);
+        writeValue<uint32_t>(out, THEME_CACHE_VERSION);
+        writeValue<uint32_t>(out, count);
+
+        for (auto& file : files) {
+            if (file.theme.fn.size()) {
+                writeValue<uint8_t>(out, 1);
+                file.theme.Write(out);
+                writeValue<int64_t>(out, file.mtime);
+                writeValue<int64_t>(out, file.size);
+            }
+        }
+
+        for (auto& file : failed) {
+            writeValue<uint8_t>(out, 0);
+            writeString(out, file.theme.fn);
+            writeValue<int64_t>(out, file.mtime);
+            writeValue<int64_t>(out, file.size);
+        }
+
+        if (!out.good()) {
+            out.close();
+            std::remove(temp.c_str());
+            return;
+        }
+    }
+
+    /* swap it in whole, so a reader never sees a partial file. rename()
+    replaces the target atomically on POSIX, but fails if it exists on
+    windows. */
+#ifdef WIN32
+    std::remove(fn.c_str());
+#endif
+    std::rename(temp.c_str(), fn.c_str());
+}
+
+static bool indexThemes(
+    const std::string& directory,
+    std::map<std::string, ThemeFile>& cached,
+    std::vector<ThemeFile>& target,
+    std::vector<ThemeFile>& failed)
+{
+    bool changed = false;
 
-static void indexThemes(const std::string& directory) {
     for (auto fn : fs::FindFilesWithExtensions(directory, { "json" }, false)) {
-        Theme theme;
-        if (theme.LoadFromFile(fn)) {
-            ::themes.push_back(theme);
+        ThemeFile file;
+
+        if (!statFile(fn, file.mtime, file.size)) {
+            continue;
+        }
+
+        auto it = cached.find(fn);
+        if (it != cached.end() &&
+            it->second.mtime == file.mtime &&
+            it->second.size == file.size)
+        {
+            /* cache hit, no parsing */
+            (it->second.loaded ? target : failed).push_back(it->second);
+            cached.erase(it);
+        }
+        else {
+            if (file.theme.LoadFromFile(fn)) {
+                target.push_back(file);
+            }
+            else {
+                file.theme.fn = fn;
+                file.loaded = false;
+                failed.push_back(file);
+            }
+            changed = true;
         }
     }
+
+    return changed;
 }
 
-static void indexThemes() {
-    if (!::themes.size()) {
-        ::themes.push_back(Theme()); /* default */
+static std::vector<std::string> themeDirectories() {
+    return {
+        f8n::env::GetApplicationDirectory() + "/themes/",
+        f8n::env::GetDataDirectory() + "/themes/"
+    };
+}
+
+static bool compareThemeNames(const ThemeFile& a, const ThemeFile& b) {
+    return a.theme.name < b.theme.name;
+}
 
-        indexThemes(f8n::env::GetApplicationDirectory() + "/themes/");
-        indexThemes(f8n::env::GetDataDirectory() + "/themes/");
+static std::vector<ThemeFile> indexThemes() {
+    std::map<std::string, ThemeFile> cached;
+    std::vector<ThemeFile> result, failed;
 
-        std::sort(
-            ::themes.begin(),
-            ::themes.end(),
-            [](const Theme& a, const Theme& b) -> bool {
-                return a.name < b.name;
-            });
+    readCache(cached);
+
+    ThemeFile defaultTheme;
+    defaultTheme.mtime = defaultTheme.size = 0;
+    result.push_back(defaultTheme);
+
+    bool changed = false;
+    for (auto& dir : themeDirectories()) {
+        changed |= indexThemes(dir, cached, result, failed);
+    }
+    changed |= !cached.empty(); /* files that have since been removed */
+
+    if (changed) {
+        writeCache(result, failed);
+    }
+
+    std::sort(result.begin(), result.end(), compareThemeNames);
+
+    return result;
+}
+
+static std::string lastTheme = "default";
+static Colors::Mode colorMode = Colors::Basic;
+static Colors::BgType bgType = Colors::Theme;
+static bool colorsInitialized = false;
+static bool themeApplied = false;
+
+static void applyTheme(const std::string& name);
+
+/* indexes themes on a background thread, so startup never waits on theme
+I/O. a theme requested before indexing finishes is applied once it's done,
+from the main loop, via the message queue. */
+class ThemeIndex : public IMessageTarget {
+    public:
+        ThemeIndex() : started(false), ready(false) {
+        }
+
+        ~ThemeIndex() {
+            if (this->thread.joinable()) {
+                this->thread.join();
+            }
+        }
+
+        void Start() {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            if (!this->started) {
+                this->started = true;
+                this->thread = std::thread([this] {
+                    auto result = indexThemes();
+                    {
+                        std::unique_lock<std::mutex> lock(this->mutex);
+                        this->themes = std::move(result);
+                        this->ready = true;
+                    }
+                    this->condition.notify_all();
+                    Window::MessageQueue().Post(
+                        Message::Create(this, MESSAGE_THEMES_INDEXED, 0, 0));
+                });
+            }
+        }
+
+        bool Ready() {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            return this->ready;
+        }
+
+        std::vector<ThemeFile> Themes() {
+            this->Start();
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->condition.wait(lock, [this] { return this->ready; });
+            return this->themes;
+        }
+
+        /* replaces the indexed copy of a theme that was re-parsed */
+        void Update(const ThemeFile& file) {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            auto it = std::find_if(
+                this->themes.begin(),
+                this->themes.end(),
+                [&file](const ThemeFile& t) { return t.theme.fn == file.theme.fn; });
+
+            if (it != this->themes.end()) {
+                *it = file;
+            }
+            else {
+                this->themes.push_back(file);
+            }
+
+            std::sort(this->themes.begin(), this->themes.end(), compareThemeNames);
+        }
+
+        virtual void ProcessMessage(IMessage& message) override {
+            if (message.Type() == MESSAGE_THEMES_INDEXED && ::colorsInitialized) {
+                applyTheme(::lastTheme);
+                Window::InvalidateScreen();
+            }
+        }
+
+    private:
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::vector<ThemeFile> themes;
+        bool started, ready;
+};
+
+static ThemeIndex themeIndex;
+
+static void applyTheme(const std::string& name) {
+    if (!themeIndex.Ready()) {
+        /* make sure the color pairs are initialized with something
+        sensible for the first paint; the real thing comes later. */
+        if (!::themeApplied) {
+            Theme().Apply(::colorMode, ::bgType);
+            ::themeApplied = true;
+        }
+        return;
+    }
+
+    for (auto& t : themeIndex.Themes()) {
+        if (name == t.theme.name) {
+            t.theme.Apply(::colorMode, ::bgType);
+            ::themeApplied = true;
+        }
     }
 }
 
+#ifdef __linux__
+/* watches the theme directories with inotify. the watcher thread only
+collects the names of changed files; they're parsed and applied on the
+main thread, debounced, because editors tend to write files in steps. */
+class ThemeWatcher : public IMessageTarget {
+    public:
+        ThemeWatcher() : fd(-1), running(false) {
+        }
+
+        ~ThemeWatcher() {
+            this->Close();
+        }
+
+        void Start() {
+            if (this->running) {
+                return;
+            }
+
+            this->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (this->fd < 0) {
+                return;
+            }
+
+            for (auto dir : themeDirectories()) {
+                int wd = inotify_add_watch(this->fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+                if (wd >= 0) {
+                    this->directories[wd] = dir;
+                }
+            }
+
+            this->running = true;
+            this->thread = std::thread([this] { this->ThreadProc(); });
+        }
+
+        void Stop() {
+            this->Close();
+            Window::MessageQueue().Remove(this);
+        }
+
+        virtual void ProcessMessage(IMessage& message) override {
+            if (message.Type() != MESSAGE_THEME_FILE_CHANGED || !themeIndex.Ready()) {
+                return;
+            }
+
+            std::set<std::string> changed;
+            {
+                std::unique_lock<std::mutex> lock(this->mutex);
+                std::swap(changed, this->pending);
+            }
+
+            bool invalidate = false;
+            for (auto& fn : changed) {
+                ThemeFile file;
+                if (statFile(fn, file.mtime, file.size) && file.theme.LoadFromFile(fn)) {
+                    themeIndex.Update(file);
+                    if (::colorsInitialized && file.theme.name == ::lastTheme) {
+                        invalidate |= file.theme.Apply(::colorMode, ::bgType);
+                    }
+                }
+            }
+
+            if (invalidate) {
+                Window::InvalidateScreen();
+            }
+        }
+
+    private:
+        void Close() {
+            if (this->running) {
+                this->running = false;
+                this->thread.join();
+            }
+
+            if (this->fd >= 0) {
+                close(this->fd);
+                this->fd = -1;
+            }
+
+            this->directories.clear();
+        }
+
+        void ThreadProc() {
+            /* large enough for a burst of events with file names */
+            alignas(struct inotify_event) char buffer[4096];
+            pollfd pfd = { this->fd, POLLIN, 0 };
+
+            while (this->running) {
+                if (poll(&pfd, 1, THEME_WATCH_POLL_MS) <= 0) {
+                    continue;
+                }
+
+                bool found = false;
+                ssize_t length;
+                while ((length = read(this->fd, buffer, sizeof(buffer))) > 0) {
+                    for (char* p = buffer; p < buffer + length; ) {
+                        auto event = (struct inotify_event*) p;
+                        p += sizeof(struct inotify_event) + event->len;
+
+                        std::string name = event->len ? event->name : "";
+                        auto dir = this->directories.find(event->wd);
+                        if (dir != this->directories.end() &&
+                            name.size() > 5 &&
+                            name.substr(name.size() - 5) == ".json")
+                        {
+                            std::unique_lock<std::mutex> lock(this->mutex);
+                            this->pending.insert(dir->second + name);
+                            found = true;
+                        }
+                    }
+                }
+
+                if (found) {
+                    Window::MessageQueue().Debounce(
+                        Message::Create(this, MESSAGE_THEME_FILE_CHANGED, 0, 0),
+                        THEME_WATCH_DEBOUNCE_MS);
+                }
+            }
+        }
+
+        std::thread thread;
+        std::mutex mutex;
+        std::set<std::string> pending;
+        std::map<int, std::string> directories;
+        int fd;
+        std::atomic<bool> running;
+};
+
+static ThemeWatcher themeWatcher;
+#endif
+
 void Colors::Init(Colors::Mode mode, Colors::BgType bgType) {
     start_color();
     use_default_colors();
 
     ::colorMode = Colors::Basic;
     ::bgType = bgType;
+    ::themeApplied = false;
+    resetAppliedSlots();
+
+    colorPairs.SetRange(
+        FIRST_DYNAMIC_PAIR, std::min(COLOR_PAIRS, MAX_ATTRIBUTE_PAIRS));
 
     if (mode != Colors::Basic && COLORS > 8) {
-        if (mode == Colors::RGB && canChangeColors()) {
+        if (mode == Colors::DirectRGB && supportsDirectColor()) {
+            ::colorMode = Colors::DirectRGB;
+        }
+        else if ((mode == Colors::RGB || mode == Colors::DirectRGB) && canChangeColors()) {
             ::colorMode = Colors::RGB;
         }
         else {
@@ -557,24 +1179,79 @@ void Colors::Init(Colors::Mode mode, Colors::BgType bgType) {
         }
     }
 
+    ::colorsInitialized = true;
+    themeIndex.Start();
     SetTheme(::lastTheme);
 }
 
 void Colors::SetTheme(const std::string& name) {
-    indexThemes();
-    for (auto& t : ::themes) {
-        if (name == t.name) {
-            ::lastTheme = name;
-            t.Apply(::colorMode, ::bgType);
-        }
+    ::lastTheme = name;
+    if (::colorsInitialized) {
+        applyTheme(name);
+    }
+}
+
+void Colors::WatchThemes(bool watch) {
+#ifdef __linux__
+    if (watch) {
+        themeIndex.Start();
+        themeWatcher.Start();
+    }
+    else {
+        themeWatcher.Stop();
+    }
+#endif
+}
+
+Colors::Mode Colors::GetMode() {
+    return ::colorMode;
+}
+
+int Colors::Rgb(int r, int g, int b) {
+    if (::colorMode == Colors::DirectRGB) {
+        return directColor(r, g, b);
+    }
+    else if (::colorMode == Colors::Basic || COLORS < 256) {
+        return (r > 127 ? COLOR_RED : 0) | (g > 127 ? COLOR_GREEN : 0) | (b > 127 ? COLOR_BLUE : 0);
+    }
+
+    /* nearest entry in the 6x6x6 cube, or the grayscale ramp if closer */
+    auto level = [](int value) {
+        return value < 48 ? 0 : value < 115 ? 1 : (value - 35) / 40;
+    };
+
+    static const int levels[] = { 0, 95, 135, 175, 215, 255 };
+    int ri = level(r), gi = level(g), bi = level(b);
+    int cr = levels[ri], cg = levels[gi], cb = levels[bi];
+
+    int average = (r + g + b) / 3;
+    int grayIndex = average > 238 ? 23 : std::max(0, (average - 3) / 10);
+    int gray = 8 + grayIndex * 10;
+
+    auto distance = [r, g, b](int cr, int cg, int cb) {
+        return (r - cr) * (r - cr) + (g - cg) * (g - cg) + (b - cb) * (b - cb);
+    };
+
+    int cube = 16 + (36 * ri) + (6 * gi) + bi;
+
+    /* in RGB mode the theme owns the start of the cube */
+    bool themeSlot = ::colorMode == Colors::RGB && cube <= THEME_COLOR_FOOTER_FOREGROUND;
+
+    if (themeSlot || distance(gray, gray, gray) < distance(cr, cg, cb)) {
+        return 232 + grayIndex;
     }
+
+    return cube;
+}
+
+Color Colors::Pair(int foreground, int background) {
+    return Color((Color::Type) colorPairs.Acquire(foreground, background));
 }
 
 std::vector<std::string> Colors::ListThemes() {
-    indexThemes();
     std::vector<std::string> names;
-    for (auto& t : ::themes) {
-        names.push_back(t.name);
+    for (auto& t : themeIndex.Themes()) {
+        names.push_back(t.theme.name);
     }
     return names;
 }
@@ -0,0 +1,204 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <cursespp/CommandPaletteOverlay.h>
+
+#include <f8n/str/utf.h>
+
+#include <cursespp/App.h>
+#include <cursespp/Colors.h>
+#include <cursespp/CommandRegistry.h>
+#include <cursespp/ListOverlay.h>
+#include <cursespp/ScrollAdapterBase.h>
+#include <cursespp/SingleLineEntry.h>
+#include <cursespp/Text.h>
+#include <cursespp/Window.h>
+
+#include <algorithm>
+
+using namespace f8n::utf;
+using namespace cursespp;
+
+using SinglePtr = std::shared_ptr<SingleLineEntry>;
+
+#define MAX_RESULTS 64
+
+class CommandListAdapter : public ScrollAdapterBase {
+    public:
+        CommandListAdapter(CommandRegistry& registry) : registry(registry) {
+            this->Update();
+        }
+
+        virtual ~CommandListAdapter() {
+        }
+
+        const std::string& GetQuery() const {
+            return this->query;
+        }
+
+        void SetQuery(const std::string& query) {
+            this->query = query;
+            this->Update();
+        }
+
+        std::string GetId(size_t index) {
+            this->Validate();
+            if (index >= this->matches.size()) {
+                return "";
+            }
+            return this->registry.Commands()[this->matches[index].index].id;
+        }
+
+        virtual size_t GetEntryCount() override {
+            this->Validate();
+            return this->matches.size();
+        }
+
+        virtual EntryPtr GetEntry(cursespp::ScrollableWindow* window, size_t index) override {
+            this->Validate();
+
+            if (index >= this->matches.size()) {
+                return SinglePtr(new SingleLineEntry(""));
+            }
+
+            auto& command = this->registry.Commands()[this->matches[index].index];
+            int width = window->GetContentWidth();
+            int avail = std::max(0, width - int(u8cols(command.title)) - 1 - 1);
+            auto display = " " + command.title + " " +
+                text::Align(command.sequence + " ", text::AlignRight, avail);
+
+            SinglePtr result = SinglePtr(new SingleLineEntry(text::Ellipsize(display, width)));
+
+            result->SetAttrs(Color(Color::Default));
+            if (index == window->GetScrollPosition().logicalIndex) {
+                result->SetAttrs(Color(Color::ListItemHighlighted));
+            }
+
+            return result;
+        }
+
+    private:
+        /* match indexes are only good for the generation they came from;
+        windows (and their commands) may come and go while we're visible. */
+        void Validate() {
+            if (this->generation != this->registry.Generation()) {
+                this->Update();
+            }
+        }
+
+        void Update() {
+            size_t limit = this->query.empty()
+                ? this->registry.Commands().size() : MAX_RESULTS;
+
+            this->registry.Find(this->query, limit, this->matches);
+            this->generation = this->registry.Generation();
+        }
+
+        CommandRegistry& registry;
+        CommandRegistry::MatchList matches;
+        std::string query;
+        size_t generation;
+};
+
+static bool isText(const std::string& key) {
+    if (key.empty()) {
+        return false;
+    }
+    unsigned char c = (unsigned char) key[0];
+    return (key.size() == 1 && c >= 32 && c != 127) || c >= 0x80;
+}
+
+static void eraseLast(std::string& query) {
+    while (query.size() && ((unsigned char) query.back() & 0xC0) == 0x80) {
+        query.pop_back();
+    }
+    if (query.size()) {
+        query.pop_back();
+    }
+}
+
+static std::string titleFor(const std::string& title, const std::string& query) {
+    return query.empty() ? title : title + ": " + query;
+}
+
+CommandPaletteOverlay::CommandPaletteOverlay() {
+
+}
+
+void CommandPaletteOverlay::Show(const std::string& title) {
+    auto& registry = Window::Commands();
+    auto adapter = std::make_shared<CommandListAdapter>(registry);
+    auto selected = std::make_shared<std::string>();
+    std::shared_ptr<ListOverlay> dialog(new ListOverlay());
+
+    dialog->SetAdapter(adapter)
+        .SetTitle(title)
+        .SetWidthPercent(60)
+        .SetSelectedIndex(0)
+        .SetKeyInterceptorCallback(
+            [adapter, title](ListOverlay* overlay, std::string key) -> bool {
+                std::string query = adapter->GetQuery();
+
+                if (key::Intern(key) == key::Backspace) {
+                    eraseLast(query);
+                }
+                else if (isText(key)) {
+                    query += key;
+                }
+                else {
+                    return false;
+                }
+
+                if (query != adapter->GetQuery()) {
+                    adapter->SetQuery(query);
+                    overlay->SetTitle(titleFor(title, query));
+                    overlay->RefreshAdapter();
+                    overlay->SetSelectedIndex(0);
+                }
+
+                return true;
+            })
+        .SetItemSelectedCallback(
+            [adapter, selected](ListOverlay* overlay, IScrollAdapterPtr, size_t index) {
+                *selected = adapter->GetId(index);
+            })
+        .SetDismissedCallback(
+            [selected](ListOverlay* overlay) {
+                if (selected->size()) {
+                    Window::Commands().Execute(*selected);
+                }
+            });
+
+    App::Overlays().Push(dialog);
+}
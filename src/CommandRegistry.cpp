@@ -0,0 +1,439 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <cursespp/CommandRegistry.h>
+#include <cursespp/App.h>
+#include <cursespp/IWindow.h>
+#include <cursespp/Window.h>
+
+#include <algorithm>
+
+using namespace cursespp;
+
+#define SUBSTRING_SCORE 1000
+
+static inline char lower(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char)(c + ('a' - 'A')) : c;
+}
+
+static std::string lowercase(const std::string& input) {
+    std::string result = input;
+    std::transform(result.begin(), result.end(), result.begin(), lower);
+    return result;
+}
+
+static std::string trim(const std::string& input) {
+    size_t start = input.find_first_not_of(' ');
+    if (start == std::string::npos) {
+        return "";
+    }
+    size_t end = input.find_last_not_of(' ');
+    return input.substr(start, end - start + 1);
+}
+
+/* one bit per letter and digit. a title can only match a query if it has
+every bit the query has. */
+static uint64_t charMask(const std::string& lowered) {
+    uint64_t mask = 0;
+    for (unsigned char c : lowered) {
+        if (c >= 'a' && c <= 'z') {
+            mask |= 1ULL << (c - 'a');
+        }
+        else if (c >= '0' && c <= '9') {
+            mask |= 1ULL << (26 + c - '0');
+        }
+    }
+    return mask;
+}
+
+static inline uint32_t trigram(const std::string& s, size_t i) {
+    return
+        ((uint32_t)(unsigned char) s[i] << 16) |
+        ((uint32_t)(unsigned char) s[i + 1] << 8) |
+        (uint32_t)(unsigned char) s[i + 2];
+}
+
+static inline bool wordStart(const std::string& s, size_t i) {
+    if (i == 0) {
+        return true;
+    }
+    char c = s[i - 1];
+    return c == ' ' || c == '-' || c == '_' || c == '/' || c == ':' || c == '.';
+}
+
+static int substringScore(const std::string& title, const std::string& query, size_t pos) {
+    int score = SUBSTRING_SCORE + 4 * (int) query.size();
+    if (pos == 0) {
+        score += 40;
+    }
+    else if (wordStart(title, pos)) {
+        score += 20;
+    }
+    return score - (int) std::min(pos, (size_t) 20) - (int) (title.size() / 8);
+}
+
+/* greedy subsequence match; false if the query isn't a subsequence of
+the title. consecutive characters and word starts score higher, gaps lower. */
+static bool fuzzyMatch(const std::string& title, const std::string& query, int& score) {
+    size_t from = 0, last = std::string::npos;
+    int run = 0;
+    score = 0;
+
+    for (char c : query) {
+        size_t pos = title.find(c, from);
+        if (pos == std::string::npos) {
+            return false;
+        }
+
+        if (wordStart(title, pos)) {
+            score += 8;
+        }
+
+        if (last != std::string::npos && pos == last + 1) {
+            score += 4 * (++run);
+        }
+        else {
+            run = 0;
+            if (last != std::string::npos) {
+                score -= (int) std::min(pos - last - 1, (size_t) 5);
+            }
+        }
+
+        last = pos;
+        from = pos + 1;
+    }
+
+    score -= (int) (title.size() / 8);
+    return true;
+}
+
+static std::shared_ptr<Keymap> keymapFor(IWindow* owner, bool create) {
+    auto& keymaps = Window::Keymaps();
+    auto keymap = owner ? keymaps.Get(owner) : keymaps.GetGlobal();
+    if (!keymap && create) {
+        keymap = std::make_shared<Keymap>();
+        if (owner) {
+            keymaps.Set(owner, keymap);
+        }
+        else {
+            keymaps.SetGlobal(keymap);
+        }
+    }
+    return keymap;
+}
+
+static void unbind(const CommandRegistry::Command& command) {
+    if (command.action && command.sequence.size()) {
+        auto keymap = keymapFor(command.owner, false);
+        if (keymap) {
+            keymap->Unbind(command.sequence);
+        }
+    }
+}
+
+CommandRegistry::CommandRegistry()
+: generation(0)
+, indexedGeneration((size_t) -1) {
+}
+
+CommandRegistry::~CommandRegistry() {
+}
+
+bool CommandRegistry::Register(
+    IWindow* owner,
+    const std::string& id,
+    const std::string& title,
+    const std::string& sequence,
+    Action action)
+{
+    if (id.empty() || (!action && sequence.empty())) {
+        return false;
+    }
+
+    std::vector<KeyId> keys;
+    if (sequence.size() && !Keymap::Parse(sequence, keys)) {
+        return false;
+    }
+
+    auto it = this->ids.find(id);
+    if (it != this->ids.end()) {
+        unbind(this->commands[it->second]);
+    }
+
+    if (action && sequence.size()) {
+        keymapFor(owner, true)->Bind(sequence, action, title);
+    }
+
+    Command command { id, title, sequence, owner, action };
+
+    if (it != this->ids.end()) {
+        this->commands[it->second] = command; /* keeps its position */
+    }
+    else {
+        this->ids[id] = this->commands.size();
+        this->commands.push_back(command);
+    }
+
+    ++this->generation;
+    return true;
+}
+
+bool CommandRegistry::Unregister(const std::string& id) {
+    auto it = this->ids.find(id);
+    if (it == this->ids.end()) {
+        return false;
+    }
+
+    unbind(this->commands[it->second]);
+    this->Erase(it->second);
+    return true;
+}
+
+void CommandRegistry::Remove(IWindow* owner) {
+    /* called for every window that's destroyed, so keep the common case
+    (it owns nothing) to a single pass without allocating. the owner's
+    keymap layer is removed along with it, so nothing needs unbinding. */
+    auto owned = [owner](const Command& command) {
+        return command.owner == owner;
+    };
+
+    if (!owner || std::none_of(this->commands.begin(), this->commands.end(), owned)) {
+        return;
+    }
+
+    this->commands.erase(
+        std::remove_if(this->commands.begin(), this->commands.end(), owned),
+        this->commands.end());
+
+    this->ids.clear();
+    for (size_t i = 0; i < this->commands.size(); i++) {
+        this->ids[this->commands[i].id] = i;
+    }
+
+    ++this->generation;
+}
+
+void CommandRegistry::Clear() {
+    for (auto& command : this->commands) {
+        unbind(command);
+    }
+
+    this->commands.clear();
+    this->ids.clear();
+    ++this->generation;
+}
+
+void CommandRegistry::Erase(size_t index) {
+    this->ids.erase(this->commands[index].id);
+    this->commands.erase(this->commands.begin() + index);
+
+    for (auto& it : this->ids) {
+        if (it.second > index) {
+            --it.second;
+        }
+    }
+
+    ++this->generation;
+}
+
+const CommandRegistry::Command* CommandRegistry::Get(const std::string& id) const {
+    auto it = this->ids.find(id);
+    return (it == this->ids.end()) ? nullptr : &this->commands[it->second];
+}
+
+bool CommandRegistry::Execute(const std::string& id) {
+    const Command* command = this->Get(id);
+    if (!command) {
+        return false;
+    }
+
+    if (command->action) {
+        if (command->sequence.size()) {
+            auto keymap = keymapFor(command->owner, false);
+            if (keymap && keymap->Invoke(command->sequence)) {
+                return true;
+            }
+        }
+
+        /* copied; the action may unregister the command */
+        Action action = command->action;
+        action();
+        return true;
+    }
+
+    /* bound somewhere we can't see; press the keys */
+    std::vector<KeyId> keys;
+    if (Keymap::Parse(command->sequence, keys)) {
+        for (auto key : keys) {
+            App::Instance().InjectKeyPress(key::Name(key));
+        }
+        return true;
+    }
+
+    return false;
+}
+
+void CommandRegistry::BuildIndex() {
+    size_t count = this->commands.size();
+
+    this->titles.resize(count);
+    this->masks.resize(count);
+    this->trigrams.clear();
+
+    for (size_t i = 0; i < count; i++) {
+        std::string& title = this->titles[i];
+        title = lowercase(this->commands[i].title);
+        this->masks[i] = charMask(title);
+
+        for (size_t j = 0; j + 3 <= title.size(); j++) {
+            auto& postings = this->trigrams[trigram(title, j)];
+            if (postings.empty() || postings.back() != (uint32_t) i) {
+                postings.push_back((uint32_t) i);
+            }
+        }
+    }
+
+    this->indexedGeneration = this->generation;
+}
+
+void CommandRegistry::Find(const std::string& query, size_t limit, MatchList& results) {
+    results.clear();
+
+    if (this->indexedGeneration != this->generation) {
+        this->BuildIndex();
+    }
+
+    auto available = [this](size_t index) {
+        IWindow* owner = this->commands[index].owner;
+        return !owner || owner->IsVisible();
+    };
+
+    std::string q = lowercase(trim(query));
+    size_t count = this->commands.size();
+
+    if (q.empty()) {
+        for (size_t i = 0; i < count && results.size() < limit; i++) {
+            if (available(i)) {
+                results.push_back({ i, 0 });
+            }
+        }
+        return;
+    }
+
+    std::vector<bool> matched(count, false);
+
+    /* substring matches: intersect the posting lists of the query's
+    trigrams, smallest first, then confirm. */
+    if (q.size() >= 3) {
+        std::vector<const std::vector<uint32_t>*> lists;
+        for (size_t j = 0; j + 3 <= q.size(); j++) {
+            auto it = this->trigrams.find(trigram(q, j));
+            if (it == this->trigrams.end()) {
+                lists.clear();
+                break;
+            }
+            lists.push_back(&it->second);
+        }
+
+        if (lists.size()) {
+            std::sort(lists.begin(), lists.end(),
+                [](const std::vector<uint32_t>* a, const std::vector<uint32_t>* b) {
+                    return a->size() < b->size();
+                });
+
+            std::vector<uint32_t> candidates = *lists[0], scratch;
+            for (size_t j = 1; j < lists.size() && candidates.size(); j++) {
+                scratch.clear();
+                std::set_intersection(
+                    candidates.begin(), candidates.end(),
+                    lists[j]->begin(), lists[j]->end(),
+                    std::back_inserter(scratch));
+                candidates.swap(scratch);
+            }
+
+            for (uint32_t i : candidates) {
+                size_t pos = this->titles[i].find(q);
+                if (pos != std::string::npos && available(i)) {
+                    results.push_back({ i, substringScore(this->titles[i], q, pos) });
+                    matched[i] = true;
+                }
+            }
+        }
+    }
+
+    /* substring matches always outrank fuzzy ones, so only look for the
+    latter if there's room left. */
+    if (results.size() < limit) {
+        uint64_t mask = charMask(q);
+        for (size_t i = 0; i < count; i++) {
+            if (matched[i] || (this->masks[i] & mask) != mask || !available(i)) {
+                continue;
+            }
+
+            const std::string& title = this->titles[i];
+
+            if (q.size() < 3) {
+                size_t pos = title.find(q);
+                if (pos != std::string::npos) {
+                    results.push_back({ i, substringScore(title, q, pos) });
+                    continue;
+                }
+            }
+
+            int score;
+            if (fuzzyMatch(title, q, score)) {
+                results.push_back({ i, score });
+            }
+        }
+    }
+
+    auto& titles = this->titles;
+    auto compare = [&titles](const Match& a, const Match& b) {
+        if (a.score != b.score) {
+            return a.score > b.score;
+        }
+        if (titles[a.index].size() != titles[b.index].size()) {
+            return titles[a.index].size() < titles[b.index].size();
+        }
+        return a.index < b.index;
+    };
+
+    if (results.size() > limit) {
+        std::partial_sort(results.begin(), results.begin() + limit, results.end(), compare);
+        results.resize(limit);
+    }
+    else {
+        std::sort(results.begin(), results.end(), compare);
+    }
+}
@@ -34,14 +34,20 @@
 
 #include <cursespp/DialogOverlay.h>
 #include <cursespp/Colors.h>
+#include <cursespp/Draw.h>
 #include <cursespp/Screen.h>
 #include <cursespp/Text.h>
+#include <algorithm>
+#include <string.h>
 
 using namespace cursespp;
 
 #define HORIZONTAL_PADDING 4
 #define VERTICAL_PADDING 2
 
+/* wrapped lines that are kept around once they've scrolled out of view */
+#define MAX_WRAPPED_LINES 512
+
 DialogOverlay::DialogOverlay() {
     this->SetFrameVisible(true);
     this->SetFrameColor(Color::OverlayFrame);
@@ -51,12 +57,17 @@ DialogOverlay::DialogOverlay() {
 
     this->width = this->height = 0;
     this->autoDismiss = true;
+    this->topLine = this->topRow = 0;
+    this->endLine = this->endRow = 0;
+    this->endValid = false;
+    this->wrapWidth = this->bodyHeight = 0;
+    this->scrollable = false;
 
     this->shortcuts.reset(new ShortcutsWindow());
     this->shortcuts->SetAlignment(text::AlignRight);
 
     this->shortcuts->SetChangedCallback([this](std::string key) {
-        this->ProcessKey(key);
+        this->ProcessKey(key::Intern(key));
     });
 
     this->LayoutBase::AddWindow(this->shortcuts);
@@ -96,7 +107,8 @@ DialogOverlay& DialogOverlay::SetTitle(const std::string& title) {
 
 DialogOverlay& DialogOverlay::SetMessage(const std::string& message) {
     this->message = message;
-    this->width = 0; /* implicitly triggers a new BreakLines() */
+    this->IndexLines();
+    this->width = 0; /* implicitly invalidates wrapped lines */
     this->RecalculateSize();
     this->Layout();
     this->Clear();
@@ -109,6 +121,17 @@ DialogOverlay& DialogOverlay::SetAutoDismiss(bool dismiss) {
     return *this;
 }
 
+DialogOverlay& DialogOverlay::ScrollToLine(size_t line) {
+    if (this->lineOffsets.size()) {
+        this->topLine = std::min(line, this->lineOffsets.size() - 1);
+        this->topRow = 0;
+        this->ClampToEnd();
+        this->Redraw();
+        this->Invalidate();
+    }
+    return *this;
+}
+
 DialogOverlay& DialogOverlay::ClearButtons() {
     this->shortcuts->RemoveAll();
     this->buttons.clear();
@@ -122,8 +145,8 @@ DialogOverlay& DialogOverlay::AddButton(
     ButtonCallback callback)
 {
     this->shortcuts->AddShortcut(key, caption);
-    this->buttons[rawKey] = callback; /* for KeyPress() */
-    this->buttons[key] = callback; /* for ShortcutsWindow::ChangedCallback */
+    this->buttons[key::Intern(rawKey)] = callback; /* for KeyPress() */
+    this->buttons[key::Intern(key)] = callback; /* for ShortcutsWindow::ChangedCallback */
     this->Layout();
     this->Invalidate();
     return *this;
@@ -134,14 +157,14 @@ DialogOverlay& DialogOverlay::OnDismiss(DismissCallback dismissCb) {
     return *this;
 }
 
-bool DialogOverlay::ProcessKey(const std::string& key) {
+bool DialogOverlay::ProcessKey(KeyId key) {
     auto it = this->buttons.find(key);
 
     if (it != this->buttons.end()) {
         ButtonCallback cb = it->second;
 
         if (cb) {
-            cb(key);
+            cb(key::Name(key));
         }
 
         if (this->autoDismiss) {
@@ -154,8 +177,28 @@ bool DialogOverlay::ProcessKey(const std::string& key) {
     return false;
 }
 
-bool DialogOverlay::KeyPress(const std::string& key) {
-    if (this->ProcessKey(key)) {
+bool DialogOverlay::ScrollKey(KeyId key) {
+    if (!this->scrollable) {
+        return false;
+    }
+
+    auto& keys = NavigationKeys();
+
+    if (keys.Down(key)) { this->ScrollDown(1); }
+    else if (keys.Up(key)) { this->ScrollUp(1); }
+    else if (keys.PageDown(key)) { this->ScrollDown(this->bodyHeight); }
+    else if (keys.PageUp(key)) { this->ScrollUp(this->bodyHeight); }
+    else if (keys.Home(key)) { this->topLine = this->topRow = 0; }
+    else if (keys.End(key)) { this->topLine = (size_t) -1; this->ClampToEnd(); }
+    else { return false; }
+
+    this->Redraw();
+    this->Invalidate();
+    return true;
+}
+
+bool DialogOverlay::KeyPress(KeyId key) {
+    if (this->ProcessKey(key) || this->ScrollKey(key)) {
         return true;
     }
     return LayoutBase::KeyPress(key);
@@ -167,32 +210,192 @@ void DialogOverlay::OnDismissed() {
     }
 }
 
+void DialogOverlay::IndexLines() {
+    this->lineOffsets.clear();
+    this->wrapped.clear();
+    this->topLine = this->topRow = 0;
+    this->endValid = false;
+
+    if (this->message.size()) {
+        const char* data = this->message.data();
+        const char* end = data + this->message.size();
+        const char* it = data;
+
+        this->lineOffsets.push_back(0);
+        while ((it = (const char*) memchr(it, '\n', end - it)) != nullptr) {
+            ++it;
+            this->lineOffsets.push_back(it - data);
+        }
+    }
+}
+
+const DialogOverlay::Rows& DialogOverlay::WrapLine(size_t line) {
+    auto it = this->wrapped.find(line);
+    if (it != this->wrapped.end()) {
+        return it->second;
+    }
+
+    size_t start = this->lineOffsets[line];
+    size_t end = (line + 1 < this->lineOffsets.size())
+        ? this->lineOffsets[line + 1] - 1 /* newline */
+        : this->message.size();
+
+    if (end > start && this->message[end - 1] == '\r') {
+        --end;
+    }
+
+    Rows& rows = this->wrapped[line];
+    text::WrapLine(this->message.substr(start, end - start), this->wrapWidth, rows);
+
+    if (rows.empty()) {
+        rows.push_back({ 0, 0, 0, 0 });
+    }
+
+    /* offsets are relative to the line; make them relative to the message */
+    for (auto& row : rows) {
+        row.offset += start;
+    }
+
+    return rows;
+}
+
+size_t DialogOverlay::CountRows(size_t maximum) {
+    size_t count = 0;
+    for (size_t i = 0; i < this->lineOffsets.size() && count < maximum; i++) {
+        count += this->WrapLine(i).size();
+    }
+    return count;
+}
+
+void DialogOverlay::ScrollDown(size_t rows) {
+    this->ClampToEnd();
+
+    for (size_t i = 0; i < rows; i++) {
+        if (this->topLine > this->endLine ||
+            (this->topLine == this->endLine && this->topRow >= this->endRow))
+        {
+            break;
+        }
+
+        if (this->topRow + 1 < this->WrapLine(this->topLine).size()) {
+            ++this->topRow;
+        }
+        else {
+            ++this->topLine;
+            this->topRow = 0;
+        }
+    }
+}
+
+void DialogOverlay::ScrollUp(size_t rows) {
+    for (size_t i = 0; i < rows; i++) {
+        if (this->topRow > 0) {
+            --this->topRow;
+        }
+        else if (this->topLine > 0) {
+            --this->topLine;
+            this->topRow = this->WrapLine(this->topLine).size() - 1;
+        }
+        else {
+            break;
+        }
+    }
+}
+
+void DialogOverlay::ClampToEnd() {
+    size_t count = this->lineOffsets.size();
+
+    if (!this->endValid) {
+        /* the last position the top can scroll to. found by walking back
+        from the end, so only the last page is wrapped. */
+        this->endLine = this->endRow = 0;
+
+        size_t remaining = (size_t) std::max(1, this->bodyHeight);
+        for (size_t i = count; i > 0; i--) {
+            size_t rows = this->WrapLine(i - 1).size();
+            if (rows >= remaining) {
+                this->endLine = i - 1;
+                this->endRow = rows - remaining;
+                break;
+            }
+            remaining -= rows;
+        }
+
+        this->endValid = true;
+    }
+
+    if (this->topLine > this->endLine ||
+        (this->topLine == this->endLine && this->topRow > this->endRow))
+    {
+        this->topLine = this->endLine;
+        this->topRow = this->endRow;
+    }
+}
+
+void DialogOverlay::PruneRows() {
+    if (this->wrapped.size() > MAX_WRAPPED_LINES) {
+        size_t last = this->topLine + (size_t) this->bodyHeight;
+        for (auto it = this->wrapped.begin(); it != this->wrapped.end(); ) {
+            if (it->first < this->topLine || it->first > last) {
+                it = this->wrapped.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+    }
+}
+
 void DialogOverlay::RecalculateSize() {
     int lastWidth = this->width;
+    int lastBodyHeight = this->bodyHeight;
 
     this->width = std::max(0, Screen::GetWidth() - (HORIZONTAL_PADDING * 2));
 
     if (lastWidth != this->width) {
         /* 4 here: 2 for the frame padding (left/right), then two for the
         inner content padding so things aren't bunched up (left/right) */
-        messageLines = text::BreakLines(this->message, this->width - 4);
+        this->wrapWidth = std::max(1, this->width - 4);
+        this->wrapped.clear();
+        this->endValid = false;
+
+        /* the top line may wrap to fewer rows now */
+        if (this->topLine < this->lineOffsets.size()) {
+            size_t rows = this->WrapLine(this->topLine).size();
+            this->topRow = std::min(this->topRow, rows - 1);
+        }
+        else {
+            this->topLine = this->topRow = 0;
+        }
     }
 
-    this->height = 0; /* top padding */
-    this->height += (this->title.size()) ? 2 : 0;
-    this->height += (this->messageLines.size()) ? messageLines.size() + 1 : 0;
-    this->height += 1; /* shortcuts */
-
     /* ensure the overlay doesn't exceed the height of the screen,
     or things may get crashy. normally this will be done for us automatically
-    in Window, but because we're free-floating we need to do it manually here. */
+    in Window, but because we're free-floating we need to do it manually here.
+    messages that don't fit become scrollable; we only wrap as many lines as
+    it takes to find out. */
     int top = this->GetY();
-    int bottom = top + this->height + VERTICAL_PADDING;
     int screenHeight = Screen::GetHeight();
-    if (bottom > screenHeight) {
-        this->height = screenHeight - top - VERTICAL_PADDING;
+    int titleHeight = (this->title.size()) ? 2 : 0;
+    int maxHeight = screenHeight - top - VERTICAL_PADDING;
+    int maxBodyHeight = std::max(0, maxHeight - titleHeight - 2); /* space + shortcuts */
+
+    size_t rows = this->CountRows((size_t) maxBodyHeight + 1);
+    this->scrollable = rows > (size_t) maxBodyHeight;
+    this->bodyHeight = (int) std::min(rows, (size_t) maxBodyHeight);
+
+    this->height = 0; /* top padding */
+    this->height += titleHeight;
+    this->height += (this->bodyHeight) ? this->bodyHeight + 1 : 0;
+    this->height += 1; /* shortcuts */
+    this->height = std::min(this->height, maxHeight);
+
+    if (lastBodyHeight != this->bodyHeight) {
+        this->endValid = false;
     }
 
+    this->ClampToEnd();
+
     int left = this->GetX();
     int right = left + this->width + HORIZONTAL_PADDING;
     int screenWidth = Screen::GetWidth();
@@ -212,18 +415,46 @@ void DialogOverlay::Redraw() {
     int currentY = 0;
 
     if (this->title.size()) {
+        /* long messages show where we are next to the title */
+        std::string position;
+        if (this->scrollable) {
+            position = std::to_string(this->topLine + 1) + "/" +
+                std::to_string(this->lineOffsets.size());
+        }
+
+        int titleWidth = this->width - 4 - (position.size() ? (int) position.size() + 1 : 0);
+
         wmove(c, currentY, currentX);
+        wclrtoeol(c);
         wattron(c, A_BOLD);
-        checked_wprintw(c, text::Ellipsize(this->title, this->width - 4).c_str());
+        draw::Text(c, text::Ellipsize(this->title, std::max(0, titleWidth)));
         wattroff(c, A_BOLD);
+
+        if (position.size()) {
+            wmove(c, currentY, currentX + this->width - 4 - (int) position.size());
+            draw::Text(c, position);
+        }
+
         currentY += 2;
     }
 
-    if (this->message.size()) {
-        for (size_t i = 0; i < messageLines.size(); i++) {
+    if (this->bodyHeight > 0) {
+        size_t line = this->topLine, row = this->topRow;
+        const char* data = this->message.data();
+
+        for (int i = 0; i < this->bodyHeight && line < this->lineOffsets.size(); i++) {
+            const Rows& rows = this->WrapLine(line);
             wmove(c, currentY, currentX);
-            checked_wprintw(c, this->messageLines.at(i).c_str());
+            wclrtoeol(c);
+            draw::Text(c, data + rows[row].offset, rows[row].bytes);
             ++currentY;
+
+            if (++row >= rows.size()) {
+                ++line;
+                row = 0;
+            }
         }
+
+        this->PruneRows();
     }
 }
@@ -0,0 +1,103 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <cursespp/Draw.h>
+#include <f8n/str/utf.h>
+#include <string.h>
+#include <algorithm>
+
+using namespace f8n::utf;
+
+#define REPEAT_CHUNK_SIZE 64
+
+namespace cursespp {
+    namespace draw {
+        void Text(WINDOW* window, const char* str, size_t bytes) {
+            if (window && str && bytes) {
+                waddnstr(window, str, (int) bytes);
+            }
+        }
+
+        void Text(WINDOW* window, const std::string& str) {
+            Text(window, str.c_str(), str.size());
+        }
+
+        void Repeat(WINDOW* window, char ch, size_t count) {
+            if (!window || !count) {
+                return;
+            }
+
+            char chunk[REPEAT_CHUNK_SIZE];
+            memset(chunk, ch, sizeof(chunk));
+
+            while (count > 0) {
+                size_t n = std::min(count, (size_t) REPEAT_CHUNK_SIZE);
+                waddnstr(window, chunk, (int) n);
+                count -= n;
+            }
+        }
+
+        void Fill(WINDOW* window, size_t columns) {
+            Repeat(window, ' ', columns);
+        }
+
+        void Line(WINDOW* window, const std::string& str, size_t columns, size_t width) {
+            Text(window, str);
+            if (columns < width) {
+                Fill(window, width - columns);
+            }
+        }
+
+        void Aligned(WINDOW* window, const std::string& str, text::TextAlign align, size_t width) {
+            size_t columns = u8cols(str);
+
+            if (columns > width) {
+                Text(window, text::Ellipsize(str, width));
+                return;
+            }
+
+            size_t left = 0;
+            if (align == text::AlignRight) {
+                left = width - columns;
+            }
+            else if (align == text::AlignCenter) {
+                left = (width - columns) / 2;
+            }
+
+            Fill(window, left);
+            Text(window, str);
+            Fill(window, width - (left + columns));
+        }
+    }
+}
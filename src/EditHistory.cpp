@@ -0,0 +1,237 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <cursespp/EditHistory.h>
+#include <f8n/str/utf.h>
+
+using namespace cursespp;
+using namespace f8n::utf;
+
+using Edit = EditHistory::Edit;
+using Transaction = EditHistory::Transaction;
+
+const size_t EditHistory::DEFAULT_MEMORY_LIMIT;
+
+static inline size_t cost(const Edit& edit) {
+    return sizeof(Edit) + edit.text.size();
+}
+
+static inline size_t cost(const Transaction& transaction) {
+    size_t total = sizeof(Transaction);
+    for (auto& edit : transaction) {
+        total += cost(edit);
+    }
+    return total;
+}
+
+static inline bool isSpace(char c) {
+    return c == ' ' || c == '\n';
+}
+
+EditHistory::EditHistory(size_t memoryLimit)
+: memoryLimit(memoryLimit)
+, memoryUsage(0)
+, groupDepth(0)
+, open(false) {
+}
+
+void EditHistory::Insert(size_t line, size_t column, const std::string& text) {
+    this->Add(Edit::Insert, line, column, text);
+}
+
+void EditHistory::Erase(size_t line, size_t column, const std::string& text) {
+    this->Add(Edit::Erase, line, column, text);
+}
+
+void EditHistory::Break() {
+    if (this->groupDepth == 0) {
+        this->open = false;
+    }
+}
+
+void EditHistory::BeginGroup() {
+    if (this->groupDepth++ == 0) {
+        this->open = false;
+    }
+}
+
+void EditHistory::EndGroup() {
+    if (this->groupDepth > 0 && --this->groupDepth == 0) {
+        this->open = false;
+    }
+}
+
+bool EditHistory::Coalesce(
+    Edit& last,
+    Edit::Type type,
+    size_t line,
+    size_t column,
+    const std::string& text,
+    size_t length)
+{
+    /* only runs of single line edits are merged */
+    if (last.type != type || last.line != line ||
+        text.find('\n') != std::string::npos ||
+        last.text.find('\n') != std::string::npos)
+    {
+        return false;
+    }
+
+    if (type == Edit::Insert) {
+        /* typing: continues where the last insert ended. a word and the
+        whitespace that follows it are one unit. */
+        if (column != last.column + last.length) {
+            return false;
+        }
+        if (text.size() && isSpace(text[0]) == false &&
+            last.text.size() && isSpace(last.text.back()))
+        {
+            return false;
+        }
+        last.text += text;
+    }
+    else if (column + length == last.column) {
+        /* backspacing */
+        last.text.insert(0, text);
+        last.column = column;
+    }
+    else if (column == last.column) {
+        /* deleting forward */
+        last.text += text;
+    }
+    else {
+        return false;
+    }
+
+    last.length += length;
+    return true;
+}
+
+void EditHistory::Add(Edit::Type type, size_t line, size_t column, const std::string& text) {
+    if (text.empty()) {
+        return;
+    }
+
+    this->ClearRedo();
+
+    size_t length = u8len(text);
+
+    if (this->open && this->undo.size() && this->undo.back().size()) {
+        Edit& last = this->undo.back().back();
+        if (this->Coalesce(last, type, line, column, text, length)) {
+            this->memoryUsage += text.size();
+            this->Trim();
+            return;
+        }
+    }
+
+    /* outside of a group, anything that can't be merged into the previous
+    edit starts a new transaction */
+    if (!this->open || this->undo.empty() || this->groupDepth == 0) {
+        this->undo.push_back(Transaction());
+        this->memoryUsage += sizeof(Transaction);
+        this->open = true;
+    }
+
+    Edit edit;
+    edit.type = type;
+    edit.line = line;
+    edit.column = column;
+    edit.length = length;
+    edit.text = text;
+
+    this->memoryUsage += cost(edit);
+    this->undo.back().push_back(std::move(edit));
+    this->Trim();
+}
+
+const Transaction* EditHistory::Undo() {
+    if (this->undo.empty()) {
+        return nullptr;
+    }
+
+    this->open = false;
+    this->redo.push_back(std::move(this->undo.back()));
+    this->undo.pop_back();
+    return &this->redo.back();
+}
+
+const Transaction* EditHistory::Redo() {
+    if (this->redo.empty()) {
+        return nullptr;
+    }
+
+    this->open = false;
+    this->undo.push_back(std::move(this->redo.back()));
+    this->redo.pop_back();
+    return &this->undo.back();
+}
+
+void EditHistory::Clear() {
+    this->undo.clear();
+    this->redo.clear();
+    this->memoryUsage = 0;
+    this->open = false;
+}
+
+void EditHistory::SetMemoryLimit(size_t bytes) {
+    this->memoryLimit = bytes;
+    this->Trim();
+}
+
+void EditHistory::ClearRedo() {
+    for (auto& transaction : this->redo) {
+        this->memoryUsage -= cost(transaction);
+    }
+    this->redo.clear();
+}
+
+void EditHistory::Trim() {
+    /* oldest first. if the transaction being built is the only thing left
+    and it's still too big, it goes too: a single enormous edit simply
+    can't be undone. */
+    while (this->memoryUsage > this->memoryLimit && this->undo.size()) {
+        this->memoryUsage -= cost(this->undo.front());
+        this->undo.pop_front();
+    }
+
+    while (this->memoryUsage > this->memoryLimit && this->redo.size()) {
+        this->memoryUsage -= cost(this->redo.front());
+        this->redo.erase(this->redo.begin());
+    }
+
+    if (this->undo.empty()) {
+        this->open = false;
+    }
+}
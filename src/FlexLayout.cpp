@@ -0,0 +1,293 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cursespp/FlexLayout.h>
+
+using namespace cursespp;
+
+/* resizing usually bounces between a handful of sizes (e.g. maximized and
+restored), so a small cache is enough to avoid re-measuring on every pass */
+#define MAX_CACHED_MEASUREMENTS 8
+
+static inline int64_t cacheKey(int width, int height) {
+    return ((int64_t) width << 32) | (uint32_t) height;
+}
+
+FlexLayout::FlexLayout(Direction direction, IWindow* parent)
+: LayoutBase(parent)
+, direction(direction)
+, spacing(0)
+, dirty(true)
+, layingOut(false)
+, lastWidth(-1)
+, lastHeight(-1)
+, lastAbsoluteX(-1)
+, lastAbsoluteY(-1) {
+}
+
+FlexLayout::~FlexLayout() {
+}
+
+void FlexLayout::SetDirection(Direction direction) {
+    if (this->direction != direction) {
+        this->direction = direction;
+        this->Relayout();
+    }
+}
+
+void FlexLayout::SetSpacing(int spacing) {
+    spacing = std::max(0, spacing);
+    if (this->spacing != spacing) {
+        this->spacing = spacing;
+        this->Relayout();
+    }
+}
+
+bool FlexLayout::AddWindow(IWindowPtr window) {
+    return this->AddWindow(window, Constraints());
+}
+
+bool FlexLayout::AddWindow(IWindowPtr window, const Constraints& constraints) {
+    for (auto& item : this->items) {
+        if (item.window == window) {
+            this->SetConstraints(window, constraints);
+            return true;
+        }
+    }
+
+    if (!LayoutBase::AddWindow(window)) {
+        return false;
+    }
+
+    this->items.push_back({ window, constraints });
+    this->Relayout();
+    return true;
+}
+
+bool FlexLayout::RemoveWindow(IWindowPtr window) {
+    auto it = std::find_if(
+        this->items.begin(),
+        this->items.end(),
+        [window](const Item& item) { return item.window == window; });
+
+    if (it != this->items.end()) {
+        this->items.erase(it);
+        this->Relayout();
+    }
+
+    return LayoutBase::RemoveWindow(window);
+}
+
+void FlexLayout::SetConstraints(IWindowPtr window, const Constraints& constraints) {
+    for (auto& item : this->items) {
+        if (item.window == window) {
+            if (!(item.constraints == constraints)) {
+                item.constraints = constraints;
+                this->Relayout();
+            }
+            return;
+        }
+    }
+}
+
+FlexLayout::Constraints FlexLayout::GetConstraints(IWindowPtr window) {
+    for (auto& item : this->items) {
+        if (item.window == window) {
+            return item.constraints;
+        }
+    }
+    return Constraints();
+}
+
+void FlexLayout::InvalidateLayout() {
+    this->dirty = true;
+    this->measureCache.clear();
+}
+
+void FlexLayout::Relayout() {
+    this->InvalidateLayout();
+
+    if (!this->layingOut) {
+        this->Layout();
+    }
+}
+
+void FlexLayout::Distribute(int available, std::vector<int>& sizes) {
+    const size_t count = this->items.size();
+    sizes.assign(count, 0);
+
+    /* everyone gets their minimum first... */
+    int remaining = available;
+    for (size_t i = 0; i < count; i++) {
+        sizes[i] = std::max(0, this->items[i].constraints.min);
+        remaining -= sizes[i];
+    }
+
+    /* ... then whatever is left is handed out proportionally by weight to
+    children that haven't reached their max. clamping a child to its max
+    frees space for the others, so we repeat until nothing changes. */
+    while (remaining > 0) {
+        int64_t totalWeight = 0;
+        for (size_t i = 0; i < count; i++) {
+            auto& c = this->items[i].constraints;
+            if (c.weight > 0 && sizes[i] < c.max) {
+                totalWeight += c.weight;
+            }
+        }
+
+        if (totalWeight == 0) {
+            break;
+        }
+
+        int distributed = 0;
+        for (size_t i = 0; i < count; i++) {
+            auto& c = this->items[i].constraints;
+            if (c.weight > 0 && sizes[i] < c.max) {
+                int share = (int) (((int64_t) remaining * c.weight) / totalWeight);
+                share = std::min(share, c.max - sizes[i]);
+                sizes[i] += share;
+                distributed += share;
+            }
+        }
+
+        if (distributed == 0) {
+            /* only rounding leftovers remain; one cell at a time, in order */
+            for (size_t i = 0; i < count && remaining > 0; i++) {
+                auto& c = this->items[i].constraints;
+                if (c.weight > 0 && sizes[i] < c.max) {
+                    ++sizes[i];
+                    --remaining;
+                }
+            }
+        }
+        else {
+            remaining -= distributed;
+        }
+    }
+}
+
+const FlexLayout::Measurement& FlexLayout::Measure(int width, int height) {
+    const int64_t key = cacheKey(width, height);
+
+    auto it = this->measureCache.find(key);
+    if (it != this->measureCache.end()) {
+        return it->second;
+    }
+
+    if (this->measureCache.size() >= MAX_CACHED_MEASUREMENTS) {
+        this->measureCache.clear();
+    }
+
+    const bool horizontal = (this->direction == Horizontal);
+    const int mainAxis = horizontal ? width : height;
+    const int crossAxis = horizontal ? height : width;
+    const int count = (int) this->items.size();
+    const int gaps = (count > 1) ? this->spacing * (count - 1) : 0;
+
+    std::vector<int> sizes;
+    this->Distribute(std::max(0, mainAxis - gaps), sizes);
+
+    Measurement& result = this->measureCache[key];
+    result.reserve(count);
+
+    int offset = 0;
+    for (int i = 0; i < count; i++) {
+        /* if the minimums don't fit, children past the end are squeezed down
+        to nothing; Window will treat them as out of bounds and hide them. */
+        int size = std::max(0, std::min(sizes[i], mainAxis - offset));
+
+        if (horizontal) {
+            result.push_back({ offset, 0, size, crossAxis });
+        }
+        else {
+            result.push_back({ 0, offset, crossAxis, size });
+        }
+
+        offset += sizes[i] + this->spacing;
+    }
+
+    return result;
+}
+
+void FlexLayout::OnLayout() {
+    if (this->layingOut) {
+        return;
+    }
+
+    const int width = this->GetContentWidth();
+    const int height = this->GetContentHeight();
+    const int absoluteX = this->GetAbsoluteX();
+    const int absoluteY = this->GetAbsoluteY();
+
+    const bool resized = width != this->lastWidth || height != this->lastHeight;
+    const bool moved = absoluteX != this->lastAbsoluteX || absoluteY != this->lastAbsoluteY;
+
+    /* nothing about us or our constraints changed, so our children are
+    already where they need to be. this is what keeps a resize from
+    cascading into subtrees whose bounds are unaffected. */
+    if (!this->dirty && !resized && !moved) {
+        return;
+    }
+
+    this->layingOut = true;
+    this->dirty = false;
+
+    /* measure everything first, then apply the results in one pass. copied
+    because a child may invalidate us (and our cache) while being moved. */
+    const Measurement rects = this->Measure(width, height);
+
+    for (size_t i = 0; i < this->items.size() && i < rects.size(); i++) {
+        auto& window = this->items[i].window;
+        const Rect& r = rects[i];
+
+        bool changed =
+            moved ||
+            !window->GetContent() ||
+            window->GetX() != r.x ||
+            window->GetY() != r.y ||
+            window->GetWidth() != r.width ||
+            window->GetHeight() != r.height;
+
+        if (changed) {
+            window->MoveAndResize(r.x, r.y, r.width, r.height);
+        }
+    }
+
+    this->lastWidth = width;
+    this->lastHeight = height;
+    this->lastAbsoluteX = absoluteX;
+    this->lastAbsoluteY = absoluteY;
+    this->layingOut = false;
+}
@@ -0,0 +1,223 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <cursespp/HitTestIndex.h>
+
+#include <algorithm>
+
+using namespace cursespp;
+
+HitTestIndex::HitTestIndex(int cellWidth, int cellHeight)
+: cellWidth(std::max(1, cellWidth))
+, cellHeight(std::max(1, cellHeight))
+, columns(0)
+, rows(0)
+, topZ(0)
+, bottomZ(0) {
+}
+
+void HitTestIndex::Grow(int columns, int rows) {
+    if (columns <= this->columns && rows <= this->rows) {
+        return;
+    }
+
+    /* re-bucket into a larger grid. only happens when the screen grows
+    beyond anything we've seen before. */
+    columns = std::max(columns, this->columns);
+    rows = std::max(rows, this->rows);
+
+    std::vector<Cell> grown((size_t) columns * rows);
+    for (int r = 0; r < this->rows; r++) {
+        for (int c = 0; c < this->columns; c++) {
+            grown[(size_t) r * columns + c].swap(
+                this->cells[(size_t) r * this->columns + c]);
+        }
+    }
+
+    this->cells.swap(grown);
+    this->columns = columns;
+    this->rows = rows;
+}
+
+void HitTestIndex::Link(IWindow* window, const Entry& entry) {
+    if (entry.width <= 0 || entry.height <= 0) {
+        return;
+    }
+
+    int left = std::max(0, entry.x) / this->cellWidth;
+    int top = std::max(0, entry.y) / this->cellHeight;
+    int right = std::max(0, entry.x + entry.width - 1) / this->cellWidth;
+    int bottom = std::max(0, entry.y + entry.height - 1) / this->cellHeight;
+
+    this->Grow(right + 1, bottom + 1);
+
+    for (int r = top; r <= bottom; r++) {
+        for (int c = left; c <= right; c++) {
+            this->cells[(size_t) r * this->columns + c].push_back(window);
+        }
+    }
+}
+
+void HitTestIndex::Unlink(IWindow* window, const Entry& entry) {
+    if (entry.width <= 0 || entry.height <= 0) {
+        return;
+    }
+
+    int left = std::max(0, entry.x) / this->cellWidth;
+    int top = std::max(0, entry.y) / this->cellHeight;
+    int right = std::min(
+        this->columns - 1, std::max(0, entry.x + entry.width - 1) / this->cellWidth);
+    int bottom = std::min(
+        this->rows - 1, std::max(0, entry.y + entry.height - 1) / this->cellHeight);
+
+    for (int r = top; r <= bottom; r++) {
+        for (int c = left; c <= right; c++) {
+            Cell& cell = this->cells[(size_t) r * this->columns + c];
+            auto it = std::find(cell.begin(), cell.end(), window);
+            if (it != cell.end()) {
+                /* order within a cell doesn't matter; z decides */
+                *it = cell.back();
+                cell.pop_back();
+            }
+        }
+    }
+}
+
+void HitTestIndex::Add(IWindow* window, int x, int y, int width, int height) {
+    this->Remove(window);
+
+    /* newly created panels go on top of the stack */
+    Entry entry { x, y, width, height, ++this->topZ };
+    this->entries[window] = entry;
+    this->Link(window, entry);
+}
+
+void HitTestIndex::Remove(IWindow* window) {
+    auto it = this->entries.find(window);
+    if (it != this->entries.end()) {
+        this->Unlink(window, it->second);
+        this->entries.erase(it);
+    }
+}
+
+void HitTestIndex::Raise(IWindow* window) {
+    auto it = this->entries.find(window);
+    if (it != this->entries.end()) {
+        it->second.z = ++this->topZ;
+    }
+}
+
+void HitTestIndex::Lower(IWindow* window) {
+    auto it = this->entries.find(window);
+    if (it != this->entries.end()) {
+        it->second.z = --this->bottomZ;
+    }
+}
+
+void HitTestIndex::Clear() {
+    this->entries.clear();
+    this->cells.clear();
+    this->columns = this->rows = 0;
+}
+
+bool HitTestIndex::Contains(IWindow* window) const {
+    return this->entries.find(window) != this->entries.end();
+}
+
+bool HitTestIndex::GetBounds(IWindow* window, int& x, int& y, int& width, int& height) const {
+    auto it = this->entries.find(window);
+    if (it != this->entries.end()) {
+        x = it->second.x;
+        y = it->second.y;
+        width = it->second.width;
+        height = it->second.height;
+        return true;
+    }
+    return false;
+}
+
+const HitTestIndex::Cell* HitTestIndex::CellAt(int x, int y) const {
+    if (x < 0 || y < 0) {
+        return nullptr;
+    }
+
+    int c = x / this->cellWidth;
+    int r = y / this->cellHeight;
+
+    if (c >= this->columns || r >= this->rows) {
+        return nullptr;
+    }
+
+    return &this->cells[(size_t) r * this->columns + c];
+}
+
+IWindow* HitTestIndex::TopmostAt(int x, int y) const {
+    const Cell* cell = this->CellAt(x, y);
+    IWindow* result = nullptr;
+    int64_t z = 0;
+
+    if (cell) {
+        for (IWindow* window : *cell) {
+            const Entry& e = this->entries.find(window)->second;
+            if (x >= e.x && x < e.x + e.width && y >= e.y && y < e.y + e.height) {
+                if (!result || e.z > z) {
+                    result = window;
+                    z = e.z;
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+void HitTestIndex::HitsAt(int x, int y, std::vector<IWindow*>& target) const {
+    target.clear();
+
+    const Cell* cell = this->CellAt(x, y);
+    if (!cell) {
+        return;
+    }
+
+    for (IWindow* window : *cell) {
+        const Entry& e = this->entries.find(window)->second;
+        if (x >= e.x && x < e.x + e.width && y >= e.y && y < e.y + e.height) {
+            target.push_back(window);
+        }
+    }
+
+    std::sort(target.begin(), target.end(), [this](IWindow* a, IWindow* b) {
+        return this->entries.find(a)->second.z > this->entries.find(b)->second.z;
+    });
+}
@@ -33,6 +33,7 @@
 //////////////////////////////////////////////////////////////////////////////
 
 #include <cursespp/App.h>
+#include <cursespp/Draw.h>
 #include <cursespp/InputOverlay.h>
 #include <cursespp/DialogOverlay.h>
 #include <cursespp/Colors.h>
@@ -122,8 +123,12 @@ void InputOverlay::OnInputKeyPress(TextInput* input, std::string key) {
     }
 }
 
-bool InputOverlay::KeyPress(const std::string& key) {
-    if (key == "^[") { /* esc closes */
+bool InputOverlay::KeyPress(KeyId key) {
+    if (key == key::Escape) { /* esc closes */
+        auto autocomplete = this->textInput->GetAutocomplete();
+        if (autocomplete && autocomplete->KeyPress(key)) {
+            return true; /* ...the suggestions first, if they're up */
+        }
         this->Dismiss();
         return true;
     }
@@ -153,6 +158,11 @@ void InputOverlay::OnInputEnterPressed(TextInput* input) {
     }
 }
 
+InputOverlay& InputOverlay::SetAutocomplete(IAutocompleteProviderPtr provider) {
+    this->textInput->SetAutocomplete(provider);
+    return *this;
+}
+
 InputOverlay& InputOverlay::SetInputMode(IInput::InputMode mode) {
     this->textInput->SetInputMode(mode);
     return *this;
@@ -196,7 +206,7 @@ void InputOverlay::Redraw() {
     if (this->title.size()) {
         wmove(c, 0, 1);
         wattron(c, A_BOLD);
-        checked_wprintw(c, text::Align(this->title, text::AlignCenter, this->width - 4).c_str());
+        draw::Aligned(c, this->title, text::AlignCenter, this->width - 4);
         wattroff(c, A_BOLD);
     }
 }
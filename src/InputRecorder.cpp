@@ -0,0 +1,254 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <cursespp/curses_config.h>
+#include <cursespp/InputRecorder.h>
+#include <cursespp/Screen.h>
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+using namespace cursespp;
+using namespace std::chrono;
+
+/* one event per line:
+
+   <time> K <key>
+   <time> M <x> <y> <state>
+   <time> R <width> <height>
+   <time> P <text>
+
+the key is everything after the type separator, so keys that contain (or are)
+spaces survive the round trip. pasted text is escaped so it stays on one
+line. */
+
+static std::string escape(const std::string& text) {
+    std::string result;
+    result.reserve(text.size());
+    for (char c : text) {
+        switch (c) {
+            case '\\': result += "\\\\"; break;
+            case '\n': result += "\\n"; break;
+            case '\r': result += "\\r"; break;
+            default: result += c; break;
+        }
+    }
+    return result;
+}
+
+static std::string unescape(const std::string& text) {
+    std::string result;
+    result.reserve(text.size());
+    for (size_t i = 0; i < text.size(); i++) {
+        if (text[i] == '\\' && i + 1 < text.size()) {
+            char c = text[++i];
+            result += (c == 'n') ? '\n' : (c == 'r') ? '\r' : c;
+        }
+        else {
+            result += text[i];
+        }
+    }
+    return result;
+}
+
+static inline int64_t steadyNow() {
+    return duration_cast<milliseconds>(
+        steady_clock::now().time_since_epoch()).count();
+}
+
+InputRecorder::InputRecorder()
+: startedAt(0)
+, recording(false) {
+}
+
+InputRecorder::~InputRecorder() {
+}
+
+void InputRecorder::Start() {
+    this->events.clear();
+    this->startedAt = steadyNow();
+    this->recording = true;
+
+    /* the terminal size is part of the workload. if curses is already up,
+    record it so playback starts with the same geometry. */
+    if (stdscr) {
+        this->RecordResize(Screen::GetWidth(), Screen::GetHeight());
+    }
+}
+
+void InputRecorder::Stop() {
+    this->recording = false;
+}
+
+void InputRecorder::Clear() {
+    this->events.clear();
+}
+
+int64_t InputRecorder::Elapsed() const {
+    return steadyNow() - this->startedAt;
+}
+
+void InputRecorder::RecordKey(const std::string& key) {
+    if (this->recording) {
+        Event event;
+        event.type = Event::Key;
+        event.time = this->Elapsed();
+        event.key = key;
+        this->events.push_back(event);
+    }
+}
+
+void InputRecorder::RecordMouse(int x, int y, int64_t state) {
+    if (this->recording) {
+        Event event;
+        event.type = Event::Mouse;
+        event.time = this->Elapsed();
+        event.x = x;
+        event.y = y;
+        event.state = state;
+        this->events.push_back(event);
+    }
+}
+
+void InputRecorder::RecordResize(int width, int height) {
+    if (this->recording) {
+        Event event;
+        event.type = Event::Resize;
+        event.time = this->Elapsed();
+        event.width = width;
+        event.height = height;
+        this->events.push_back(event);
+    }
+}
+
+void InputRecorder::RecordPaste(const std::string& text) {
+    if (this->recording) {
+        Event event;
+        event.type = Event::Paste;
+        event.time = this->Elapsed();
+        event.text = text;
+        this->events.push_back(event);
+    }
+}
+
+bool InputRecorder::Save(const std::string& filename) const {
+    std::ofstream out(filename.c_str(), std::ios::out | std::ios::trunc);
+
+    if (!out.is_open()) {
+        return false;
+    }
+
+    for (auto& e : this->events) {
+        switch (e.type) {
+            case Event::Key:
+                out << e.time << " K " << e.key << "\n";
+                break;
+            case Event::Mouse:
+                out << e.time << " M " << e.x << " " << e.y << " " << e.state << "\n";
+                break;
+            case Event::Resize:
+                out << e.time << " R " << e.width << " " << e.height << "\n";
+                break;
+            case Event::Paste:
+                out << e.time << " P " << escape(e.text) << "\n";
+                break;
+        }
+    }
+
+    return out.good();
+}
+
+bool InputRecorder::Load(const std::string& filename, EventList& target) {
+    std::ifstream in(filename.c_str());
+
+    if (!in.is_open()) {
+        return false;
+    }
+
+    EventList result;
+    std::string line;
+
+    while (std::getline(in, line)) {
+        if (!line.size()) {
+            continue;
+        }
+
+        size_t space = line.find(' ');
+        if (space == std::string::npos || space + 2 >= line.size()) {
+            return false;
+        }
+
+        Event event;
+        char type = line[space + 1];
+        std::string rest = (space + 3 <= line.size()) ? line.substr(space + 3) : "";
+        std::istringstream fields(rest);
+
+        try {
+            event.time = std::stoll(line.substr(0, space));
+        }
+        catch (...) {
+            return false;
+        }
+
+        if (type == 'K') {
+            event.type = Event::Key;
+            event.key = rest;
+        }
+        else if (type == 'M') {
+            event.type = Event::Mouse;
+            if (!(fields >> event.x >> event.y >> event.state)) {
+                return false;
+            }
+        }
+        else if (type == 'R') {
+            event.type = Event::Resize;
+            if (!(fields >> event.width >> event.height)) {
+                return false;
+            }
+        }
+        else if (type == 'P') {
+            event.type = Event::Paste;
+            event.text = unescape(rest);
+        }
+        else {
+            return false;
+        }
+
+        result.push_back(event);
+    }
+
+    target = result;
+    return true;
+}
@@ -0,0 +1,191 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <cursespp/InputReplayer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+using namespace cursespp;
+using namespace std::chrono;
+
+static inline int64_t steadyNowUs() {
+    return duration_cast<microseconds>(
+        steady_clock::now().time_since_epoch()).count();
+}
+
+static inline int64_t systemNowMs() {
+    return duration_cast<milliseconds>(
+        system_clock::now().time_since_epoch()).count();
+}
+
+static int64_t percentile(const std::vector<int64_t>& sorted, double p) {
+    if (!sorted.size()) {
+        return 0;
+    }
+    size_t index = (size_t)(p * (double)(sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+InputReplayer::InputReplayer(const EventList& events, Speed speed)
+: events(events)
+, speed(speed)
+, next(0)
+, outstanding(false)
+, dispatchedAtUs(0)
+, startedAt(0)
+, startedAtSteady(0)
+, virtualTime(0) {
+}
+
+InputReplayer::~InputReplayer() {
+}
+
+void InputReplayer::Start() {
+    this->samples.clear();
+    this->next = 0;
+    this->outstanding = false;
+    this->virtualTime = 0;
+    this->startedAt = systemNowMs();
+    this->startedAtSteady = steadyNowUs();
+}
+
+int64_t InputReplayer::Now() const {
+    if (this->speed == RealTime) {
+        return this->startedAt + (steadyNowUs() - this->startedAtSteady) / 1000;
+    }
+    return this->startedAt + this->virtualTime;
+}
+
+int64_t InputReplayer::NextEventDelay() const {
+    if (this->next >= this->events.size()) {
+        return 0;
+    }
+    int64_t delay = this->events[this->next].time - (this->Now() - this->startedAt);
+    return std::max((int64_t) 0, delay);
+}
+
+void InputReplayer::Resolve(int64_t latencyUs) {
+    if (this->outstanding) {
+        Sample& sample = this->samples.back();
+        sample.latencyUs = latencyUs;
+        this->outstanding = false;
+    }
+}
+
+bool InputReplayer::Poll(Event& target) {
+    if (this->next >= this->events.size()) {
+        /* an event that didn't result in a frame by the time the loop went
+        idle never will; don't let it hold up completion. */
+        this->Resolve(-1);
+        return false;
+    }
+
+    if (this->speed == RealTime) {
+        if (this->NextEventDelay() > 0) {
+            return false;
+        }
+    }
+    else if (this->outstanding) {
+        /* give the previous event one full loop iteration to reach the
+        screen before the next one is dispatched, otherwise its latency
+        would absorb the cost of the event that follows. */
+        this->Resolve(-1);
+        return false;
+    }
+
+    this->Resolve(-1);
+
+    target = this->events[this->next];
+
+    if (this->speed == Unthrottled) {
+        this->virtualTime = std::max(this->virtualTime, target.time);
+    }
+
+    Sample sample;
+    sample.index = this->next;
+    sample.type = target.type;
+    sample.key = target.key;
+    sample.latencyUs = -1;
+    this->samples.push_back(sample);
+
+    this->outstanding = true;
+    this->dispatchedAtUs = steadyNowUs();
+    ++this->next;
+
+    return true;
+}
+
+void InputReplayer::OnFrameWritten() {
+    if (this->outstanding) {
+        this->Resolve(steadyNowUs() - this->dispatchedAtUs);
+    }
+}
+
+bool InputReplayer::Finished() const {
+    return this->next >= this->events.size() && !this->outstanding;
+}
+
+std::string InputReplayer::Report() const {
+    std::vector<int64_t> latencies;
+    size_t dropped = 0;
+
+    for (auto& sample : this->samples) {
+        if (sample.latencyUs < 0) {
+            ++dropped;
+        }
+        else {
+            latencies.push_back(sample.latencyUs);
+        }
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+
+    std::ostringstream out;
+    out << "events: " << this->samples.size()
+        << ", drawn: " << latencies.size()
+        << ", no frame: " << dropped;
+
+    if (latencies.size()) {
+        out << ", latency us (min/p50/p90/p99/max): "
+            << latencies.front() << "/"
+            << percentile(latencies, 0.50) << "/"
+            << percentile(latencies, 0.90) << "/"
+            << percentile(latencies, 0.99) << "/"
+            << latencies.back();
+    }
+
+    return out.str();
+}
@@ -0,0 +1,129 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <cursespp/KeyId.h>
+
+#include <deque>
+#include <unordered_map>
+
+using namespace cursespp;
+
+/* ids below this value are reserved for named keys */
+#define FIRST_DYNAMIC_ID 256
+
+namespace {
+    struct Registry {
+        Registry() {
+            static const std::pair<KeyId, const char*> NAMED_KEYS[] = {
+                { key::Up, "KEY_UP" },
+                { key::Down, "KEY_DOWN" },
+                { key::Left, "KEY_LEFT" },
+                { key::Right, "KEY_RIGHT" },
+                { key::PageUp, "KEY_PPAGE" },
+                { key::PageDown, "KEY_NPAGE" },
+                { key::Home, "KEY_HOME" },
+                { key::End, "KEY_END" },
+                { key::Tab, "^I" },
+                { key::BackTab, "KEY_BTAB" },
+                { key::Enter, "KEY_ENTER" },
+                { key::Backspace, "KEY_BACKSPACE" },
+                { key::Delete, "KEY_DC" },
+                { key::Insert, "KEY_IC" },
+                { key::Escape, "^[" },
+                { key::Space, " " },
+                { key::Resize, "KEY_RESIZE" },
+                { key::Mouse, "KEY_MOUSE" },
+                { key::MetaBackspace, "M-KEY_BACKSPACE" },
+                { key::MetaEnter, "M-enter" },
+                { key::F1, "KEY_F(1)" },
+                { key::F2, "KEY_F(2)" },
+                { key::F3, "KEY_F(3)" },
+                { key::F4, "KEY_F(4)" },
+                { key::F5, "KEY_F(5)" },
+                { key::F6, "KEY_F(6)" },
+                { key::F7, "KEY_F(7)" },
+                { key::F8, "KEY_F(8)" },
+                { key::F9, "KEY_F(9)" },
+                { key::F10, "KEY_F(10)" },
+                { key::F11, "KEY_F(11)" },
+                { key::F12, "KEY_F(12)" },
+            };
+
+            /* deque, not vector: Name() hands out references */
+            this->names.resize(FIRST_DYNAMIC_ID);
+            this->ids[""] = key::None.value;
+
+            for (auto& named : NAMED_KEYS) {
+                this->names[named.first.value] = named.second;
+                this->ids[named.second] = named.first.value;
+            }
+        }
+
+        std::unordered_map<std::string, int32_t> ids;
+        std::deque<std::string> names;
+    };
+
+    static Registry& registry() {
+        static Registry instance;
+        return instance;
+    }
+}
+
+namespace cursespp {
+    namespace key {
+        KeyId Intern(const std::string& name) {
+            auto& r = registry();
+            auto it = r.ids.find(name);
+
+            if (it != r.ids.end()) {
+                return KeyId(it->second);
+            }
+
+            int32_t id = (int32_t) r.names.size();
+            r.names.push_back(name);
+            r.ids[name] = id;
+            return KeyId(id);
+        }
+
+        const std::string& Name(KeyId id) {
+            auto& r = registry();
+
+            if (id.value >= 0 && id.value < (int32_t) r.names.size()) {
+                return r.names[id.value];
+            }
+
+            return r.names[key::None.value];
+        }
+    }
+}
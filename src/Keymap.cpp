@@ -0,0 +1,195 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <cursespp/Keymap.h>
+#include <cursespp/Text.h>
+
+using namespace cursespp;
+
+static std::unordered_map<std::string, std::string> ALIASES = {
+    { "SPACE", " " },
+    { "TAB", "^I" },
+    { "ESC", "^[" },
+    { "ENTER", "KEY_ENTER" }
+};
+
+Keymap::Keymap()
+: generation(0) {
+    this->nodes.push_back(Node());
+}
+
+Keymap::~Keymap() {
+}
+
+bool Keymap::Parse(const std::string& sequence, std::vector<KeyId>& target) {
+    target.clear();
+
+    for (auto& token : text::Split(sequence, " ", true)) {
+        auto alias = ALIASES.find(token);
+        const std::string& name = (alias != ALIASES.end()) ? alias->second : token;
+        target.push_back(key::Intern(key::Normalize(name)));
+    }
+
+    return target.size() > 0;
+}
+
+bool Keymap::Bind(const std::string& sequence, Action action, const std::string& caption) {
+    Binding binding;
+
+    if (!action || !Parse(sequence, binding.keys)) {
+        return false;
+    }
+
+    binding.sequence = sequence;
+    binding.caption = caption;
+    binding.action = action;
+
+    int existing = this->Find(binding.keys);
+    if (existing >= 0) {
+        /* rebinding an existing sequence replaces it in place, so the
+        shortcut order doesn't change */
+        this->bindings[existing] = binding;
+    }
+    else {
+        this->bindings.push_back(binding);
+        this->Insert((int) this->bindings.size() - 1);
+    }
+
+    ++this->generation;
+    return true;
+}
+
+bool Keymap::Unbind(const std::string& sequence) {
+    std::vector<KeyId> keys;
+    if (Parse(sequence, keys)) {
+        int index = this->Find(keys);
+        if (index >= 0) {
+            this->bindings.erase(this->bindings.begin() + index);
+            this->Compile();
+            ++this->generation;
+            return true;
+        }
+    }
+    return false;
+}
+
+void Keymap::Clear() {
+    this->bindings.clear();
+    this->Compile();
+    ++this->generation;
+}
+
+bool Keymap::Invoke(const std::string& sequence) const {
+    std::vector<KeyId> keys;
+    if (Parse(sequence, keys)) {
+        int index = this->Find(keys);
+        if (index >= 0) {
+            Action action = this->bindings[index].action;
+            action();
+            return true;
+        }
+    }
+    return false;
+}
+
+void Keymap::Insert(int bindingIndex) {
+    int node = Root;
+
+    for (auto key : this->bindings[bindingIndex].keys) {
+        auto it = this->nodes[node].children.find(key);
+        if (it != this->nodes[node].children.end()) {
+            node = it->second;
+        }
+        else {
+            int child = (int) this->nodes.size();
+            this->nodes.push_back(Node());
+            this->nodes[node].children[key] = child;
+            node = child;
+        }
+    }
+
+    this->nodes[node].binding = bindingIndex;
+}
+
+void Keymap::Compile() {
+    this->nodes.clear();
+    this->nodes.push_back(Node());
+
+    for (int i = 0; i < (int) this->bindings.size(); i++) {
+        this->Insert(i);
+    }
+}
+
+int Keymap::Find(const std::vector<KeyId>& keys) const {
+    int node = Root;
+
+    for (auto key : keys) {
+        node = this->Next(node, key);
+        if (node == NoNode) {
+            return -1;
+        }
+    }
+
+    return this->nodes[node].binding;
+}
+
+int Keymap::Next(int node, KeyId key) const {
+    if (node < 0 || node >= (int) this->nodes.size()) {
+        return NoNode;
+    }
+
+    auto& children = this->nodes[node].children;
+    auto it = children.find(key);
+    return (it == children.end()) ? NoNode : it->second;
+}
+
+bool Keymap::HasChildren(int node) const {
+    return node >= 0 &&
+        node < (int) this->nodes.size() &&
+        this->nodes[node].children.size() > 0;
+}
+
+bool Keymap::HasAction(int node) const {
+    return node >= 0 &&
+        node < (int) this->nodes.size() &&
+        this->nodes[node].binding >= 0;
+}
+
+void Keymap::Run(int node) const {
+    if (this->HasAction(node)) {
+        /* copy: the action may rebind (and therefore replace) itself */
+        Action action = this->bindings[this->nodes[node].binding].action;
+        action();
+    }
+}
@@ -0,0 +1,183 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <cursespp/KeymapDispatcher.h>
+#include <cursespp/IWindow.h>
+#include <cursespp/Window.h>
+#include <f8n/runtime/Message.h>
+#include <algorithm>
+
+using namespace cursespp;
+using namespace f8n::runtime;
+
+#define MESSAGE_CHORD_TIMEOUT 1
+#define DEFAULT_CHORD_TIMEOUT_MS 1000
+
+KeymapDispatcher::KeymapDispatcher()
+: pendingNode(Keymap::NoNode)
+, pendingGeneration(0)
+, timeoutMs(DEFAULT_CHORD_TIMEOUT_MS) {
+}
+
+KeymapDispatcher::~KeymapDispatcher() {
+    Window::MessageQueue().Remove(this);
+}
+
+void KeymapDispatcher::Set(IWindow* owner, KeymapPtr keymap) {
+    if (!keymap) {
+        this->Remove(owner);
+    }
+    else {
+        this->layers[owner] = keymap;
+    }
+}
+
+KeymapDispatcher::KeymapPtr KeymapDispatcher::Get(IWindow* owner) const {
+    auto it = this->layers.find(owner);
+    return (it == this->layers.end()) ? KeymapPtr() : it->second;
+}
+
+void KeymapDispatcher::Remove(IWindow* owner) {
+    auto it = this->layers.find(owner);
+    if (it != this->layers.end()) {
+        if (it->second == this->pendingMap) {
+            this->Reset();
+        }
+        this->layers.erase(it);
+    }
+}
+
+void KeymapDispatcher::SetGlobal(KeymapPtr keymap) {
+    if (this->global == this->pendingMap) {
+        this->Reset();
+    }
+    this->global = keymap;
+}
+
+void KeymapDispatcher::SetChordTimeout(int64_t timeoutMs) {
+    this->timeoutMs = std::max((int64_t) 0, timeoutMs);
+}
+
+void KeymapDispatcher::Reset() {
+    Window::MessageQueue().Remove(this, MESSAGE_CHORD_TIMEOUT);
+    this->pendingMap.reset();
+    this->pendingNode = Keymap::NoNode;
+}
+
+void KeymapDispatcher::ArmTimeout() {
+    auto& queue = Window::MessageQueue();
+    queue.Remove(this, MESSAGE_CHORD_TIMEOUT);
+    queue.Post(Message::Create(this, MESSAGE_CHORD_TIMEOUT, 0, 0), this->timeoutMs);
+}
+
+bool KeymapDispatcher::Begin(const KeymapPtr& keymap, KeyId key) {
+    int node = keymap->Next(Keymap::Root, key);
+
+    if (node == Keymap::NoNode) {
+        return false;
+    }
+
+    if (keymap->HasChildren(node)) {
+        this->pendingMap = keymap;
+        this->pendingNode = node;
+        this->pendingGeneration = keymap->Generation();
+        this->ArmTimeout();
+    }
+    else {
+        keymap->Run(node);
+    }
+
+    return true;
+}
+
+bool KeymapDispatcher::Dispatch(KeyId key, IWindow* focused, IWindow* top) {
+    if (this->pendingMap) {
+        auto keymap = this->pendingMap;
+
+        if (keymap->Generation() == this->pendingGeneration) {
+            int node = keymap->Next(this->pendingNode, key);
+
+            if (node != Keymap::NoNode) {
+                if (keymap->HasChildren(node)) {
+                    this->pendingNode = node;
+                    this->ArmTimeout();
+                }
+                else {
+                    this->Reset();
+                    keymap->Run(node);
+                }
+                return true;
+            }
+        }
+
+        /* the chord was broken (or the keymap changed underneath it). drop
+        the prefix and treat this key as the start of a new sequence. */
+        this->Reset();
+    }
+
+    if (this->layers.size()) {
+        bool topVisited = false;
+
+        for (IWindow* window = focused; window; window = window->GetParent()) {
+            topVisited = topVisited || (window == top);
+            auto it = this->layers.find(window);
+            if (it != this->layers.end() && this->Begin(it->second, key)) {
+                return true;
+            }
+        }
+
+        if (top && !topVisited) {
+            auto it = this->layers.find(top);
+            if (it != this->layers.end() && this->Begin(it->second, key)) {
+                return true;
+            }
+        }
+    }
+
+    return this->global && this->Begin(this->global, key);
+}
+
+void KeymapDispatcher::ProcessMessage(IMessage &message) {
+    if (message.Type() == MESSAGE_CHORD_TIMEOUT && this->pendingMap) {
+        auto keymap = this->pendingMap;
+        int node = this->pendingNode;
+        bool valid = keymap->Generation() == this->pendingGeneration;
+
+        this->Reset();
+
+        if (valid) {
+            keymap->Run(node); /* no-op unless the prefix is itself bound */
+        }
+    }
+}
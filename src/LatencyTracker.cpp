@@ -0,0 +1,232 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <cursespp/LatencyTracker.h>
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+using namespace cursespp;
+using namespace std::chrono;
+
+/* values below LINEAR_LIMIT us get their own bucket; above that each power of
+two is split into SUB_BUCKETS linear steps, so the relative error of a
+reported percentile is bounded at 1 / SUB_BUCKETS. */
+#define LINEAR_BITS 4
+#define LINEAR_LIMIT (1 << LINEAR_BITS)
+#define SUB_BUCKET_BITS 3
+#define SUB_BUCKETS (1 << SUB_BUCKET_BITS)
+#define MAX_EXPONENT 34 /* ~4.7 hours, anything larger is clamped */
+#define BUCKET_COUNT (LINEAR_LIMIT + (MAX_EXPONENT - LINEAR_BITS + 1) * SUB_BUCKETS)
+
+/* inputs that haven't been reflected on screen after this long are assumed
+to have been no-ops (e.g. an unbound key) and are dropped, rather than being
+charged for whatever unrelated frame eventually comes along. */
+#define MAX_PENDING_US (1000 * 1000)
+
+/* upper bound on inputs waiting for a frame, so a stalled or never-drawn app
+can't grow the pending list without limit. */
+#define MAX_PENDING_COUNT 256
+
+static inline int msb(uint64_t value) {
+    int result = 0;
+    while (value >>= 1) {
+        ++result;
+    }
+    return result;
+}
+
+static size_t bucketIndex(int64_t value) {
+    if (value < LINEAR_LIMIT) {
+        return (size_t) std::max((int64_t) 0, value);
+    }
+
+    int exponent = std::min(msb((uint64_t) value), MAX_EXPONENT);
+    if (exponent == MAX_EXPONENT) {
+        return BUCKET_COUNT - 1;
+    }
+
+    size_t sub = (size_t)(value >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+    return LINEAR_LIMIT + (exponent - LINEAR_BITS) * SUB_BUCKETS + sub;
+}
+
+static int64_t bucketUpperBound(size_t index) {
+    if (index < LINEAR_LIMIT) {
+        return (int64_t) index;
+    }
+
+    size_t offset = index - LINEAR_LIMIT;
+    int exponent = (int)(offset / SUB_BUCKETS) + LINEAR_BITS;
+    int64_t sub = (int64_t)(offset % SUB_BUCKETS);
+    int64_t step = (int64_t) 1 << (exponent - SUB_BUCKET_BITS);
+    return ((int64_t) 1 << exponent) + (sub + 1) * step - 1;
+}
+
+LatencyTracker::Histogram::Histogram() {
+    this->Reset();
+}
+
+void LatencyTracker::Histogram::Reset() {
+    this->buckets.assign(BUCKET_COUNT, 0);
+    this->count = 0;
+    this->sum = this->min = this->max = 0;
+}
+
+void LatencyTracker::Histogram::Add(int64_t valueUs) {
+    valueUs = std::max((int64_t) 0, valueUs);
+    ++this->buckets[bucketIndex(valueUs)];
+    this->min = this->count ? std::min(this->min, valueUs) : valueUs;
+    this->max = std::max(this->max, valueUs);
+    this->sum += valueUs;
+    ++this->count;
+}
+
+int64_t LatencyTracker::Histogram::Mean() const {
+    return this->count ? this->sum / (int64_t) this->count : 0;
+}
+
+int64_t LatencyTracker::Histogram::Percentile(double percentile) const {
+    if (!this->count) {
+        return 0;
+    }
+
+    percentile = std::max(0.0, std::min(1.0, percentile));
+    size_t target = std::max((size_t) 1, (size_t)(percentile * this->count + 0.5));
+    size_t seen = 0;
+
+    for (size_t i = 0; i < this->buckets.size(); i++) {
+        seen += this->buckets[i];
+        if (seen >= target) {
+            return std::min(this->max, std::max(this->min, bucketUpperBound(i)));
+        }
+    }
+
+    return this->max;
+}
+
+LatencyTracker::LatencyTracker()
+: unrendered(0)
+, enabled(false) {
+}
+
+int64_t LatencyTracker::Now() {
+    return duration_cast<microseconds>(
+        steady_clock::now().time_since_epoch()).count();
+}
+
+const char* LatencyTracker::CategoryName(Category category) {
+    switch (category) {
+        case Navigation: return "navigation";
+        case TextInput: return "text input";
+        case Overlay: return "overlay";
+        default: return "other";
+    }
+}
+
+void LatencyTracker::SetEnabled(bool enabled) {
+    this->enabled = enabled;
+    if (!enabled) {
+        this->pending.clear();
+    }
+}
+
+void LatencyTracker::OnInput(Category category, int64_t timestampUs) {
+    if (this->enabled) {
+        /* pending is in arrival order, so stale entries are at the front */
+        auto end = this->pending.begin();
+        while (end != this->pending.end() &&
+            (timestampUs - end->time > MAX_PENDING_US ||
+            this->pending.end() - end >= MAX_PENDING_COUNT))
+        {
+            ++end;
+        }
+
+        if (end != this->pending.begin()) {
+            this->unrendered += (size_t)(end - this->pending.begin());
+            this->pending.erase(this->pending.begin(), end);
+        }
+
+        this->pending.push_back({ category, timestampUs });
+    }
+}
+
+void LatencyTracker::OnFrame(int64_t timestampUs) {
+    if (!this->pending.size()) {
+        return;
+    }
+
+    for (auto& p : this->pending) {
+        int64_t latency = timestampUs - p.time;
+        if (latency > MAX_PENDING_US) {
+            ++this->unrendered;
+        }
+        else {
+            this->histograms[p.category].Add(latency);
+        }
+    }
+
+    this->pending.clear();
+}
+
+const LatencyTracker::Histogram& LatencyTracker::Get(Category category) const {
+    return this->histograms[std::min((size_t) category, CategoryCount - 1)];
+}
+
+void LatencyTracker::Reset() {
+    for (auto& h : this->histograms) {
+        h.Reset();
+    }
+    this->pending.clear();
+    this->unrendered = 0;
+}
+
+std::string LatencyTracker::Report() const {
+    std::ostringstream out;
+    out << "input latency (us): count / min / p50 / p90 / p99 / max\n";
+
+    for (size_t i = 0; i < CategoryCount; i++) {
+        auto& h = this->histograms[i];
+        out << "  " << CategoryName((Category) i) << ": "
+            << h.Count() << " / "
+            << h.Min() << " / "
+            << h.Percentile(0.50) << " / "
+            << h.Percentile(0.90) << " / "
+            << h.Percentile(0.99) << " / "
+            << h.Max() << "\n";
+    }
+
+    out << "  unrendered: " << this->unrendered << "\n";
+    return out.str();
+}
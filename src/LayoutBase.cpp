@@ -41,31 +41,17 @@ using namespace cursespp;
 
 static const int NO_FOCUS = -2;
 
-template <typename T> static int find(std::vector<T>& haystack, T& needle) {
-    int i = 0;
-    typename std::vector<T>::iterator it = haystack.begin();
-    for (; it != haystack.end(); it++, i++) {
-        if ((*it) == needle) {
-            return i;
-        }
-    }
-
-    return -1;
-}
-
-bool sortByFocusOrder(IWindowPtr a, IWindowPtr b) {
-    int orderA = a->GetFocusOrder();
-    int orderB = b->GetFocusOrder();
-
-    if (orderA == orderB) {
-        return a->GetId() < b->GetId();
+template <typename T> static bool sortByFocusOrder(const T& a, const T& b) {
+    if (a.order == b.order) {
+        return a.id < b.id;
     }
 
-    return orderA < orderB;
+    return a.order < b.order;
 }
 
 LayoutBase::LayoutBase(IWindow* parent)
 : Window(parent)
+, focused(-1)
 , focusMode(FocusModeCircular) {
     this->SetFrameVisible(false);
 }
@@ -91,7 +77,6 @@ void LayoutBase::OnVisibilityChanged(bool visible) {
         }
 
         this->IndexFocusables();
-        this->SortFocusables();
     }
     else {
         for (IWindowPtr window : this->children) {
@@ -129,7 +114,17 @@ void LayoutBase::OnParentVisibilityChanged(bool visible) {
 
 void LayoutBase::OnChildVisibilityChanged(bool visible, IWindow* child) {
     Window::OnChildVisibilityChanged(visible, child);
-    this->IndexFocusables();
+
+    /* only the child that changed needs to be (re)indexed */
+    if (visible) {
+        auto it = this->childLookup.find(child);
+        if (it != this->childLookup.end() && child->IsVisible()) {
+            this->AddFocusable(it->second);
+        }
+    }
+    else {
+        this->RemoveFocusable(child);
+    }
 }
 
 void LayoutBase::BringToTop() {
@@ -166,13 +161,14 @@ bool LayoutBase::AddWindow(IWindowPtr window) {
         throw std::runtime_error("window cannot be null!");
     }
 
-    if (find(this->children, window) >= 0) {
+    if (this->childLookup.find(window.get()) != this->childLookup.end()) {
         return true;
     }
 
     window->SetParent(this);
 
     this->children.push_back(window);
+    this->childLookup[window.get()] = window;
     AddFocusable(window);
     window->Show();
 
@@ -180,7 +176,8 @@ bool LayoutBase::AddWindow(IWindowPtr window) {
 }
 
 bool LayoutBase::RemoveWindow(IWindowPtr window) {
-    this->RemoveFocusable(window);
+    this->RemoveFocusable(window.get());
+    this->childLookup.erase(window.get());
 
     std::vector<IWindowPtr>::iterator it = this->children.begin();
     for ( ; it != this->children.end(); it++) {
@@ -194,55 +191,91 @@ bool LayoutBase::RemoveWindow(IWindowPtr window) {
     return false;
 }
 
-void LayoutBase::AddFocusable(IWindowPtr window) {
+void LayoutBase::AddFocusable(const IWindowPtr& window) {
     int order = window->GetFocusOrder();
-    if (order >= 0 && find(this->focusable, window) < 0) {
-        this->focusable.push_back(window);
-        this->SortFocusables();
+    if (order < 0 || this->FindFocusable(window.get()) >= 0) {
+        return;
+    }
+
+    FocusEntry entry { order, window->GetId(), window };
+
+    auto it = std::upper_bound(
+        this->focusable.begin(),
+        this->focusable.end(),
+        entry,
+        sortByFocusOrder<FocusEntry>);
+
+    int index = (int) (it - this->focusable.begin());
+    this->focusable.insert(it, std::move(entry));
+
+    if (this->focused >= 0 && index <= this->focused) {
+        ++this->focused;
     }
 }
 
-void LayoutBase::IndexFocusables() {
-    IWindowPtr focusedWindow;
-    if (focused >= 0 && (int) this->focusable.size() > focused) {
-        focusedWindow = this->focusable.at(focused);
+void LayoutBase::RemoveFocusable(IWindow* window) {
+    int index = this->FindFocusable(window);
+    if (index < 0) {
+        return;
     }
 
-    this->focusable.clear();
-    for (IWindowPtr window : this->children) {
-        if (window->IsVisible()) {
-            AddFocusable(window);
-        }
+    this->focusable.erase(this->focusable.begin() + index);
+
+    if (this->focused == index) {
+        this->focused = -1;
+    }
+    else if (index < this->focused) {
+        --this->focused;
+    }
+}
+
+int LayoutBase::FindFocusable(IWindow* window) {
+    FocusEntry key { window->GetFocusOrder(), window->GetId(), nullptr };
+
+    auto it = std::lower_bound(
+        this->focusable.begin(),
+        this->focusable.end(),
+        key,
+        sortByFocusOrder<FocusEntry>);
+
+    if (it != this->focusable.end() && it->window.get() == window) {
+        return (int) (it - this->focusable.begin());
     }
 
-    if (focusedWindow) {
-        this->focused = find(this->focusable, focusedWindow);
+    /* the window's focus order may have changed since it was indexed; fall
+    back to a scan. this doesn't copy any shared pointers. */
+    for (size_t i = 0; i < this->focusable.size(); i++) {
+        if (this->focusable[i].window.get() == window) {
+            return (int) i;
+        }
     }
+
+    return -1;
 }
 
-void LayoutBase::SortFocusables() {
-    IWindowPtr focusedWindow;
+void LayoutBase::IndexFocusables() {
+    /* full rebuild, used when the layout itself becomes visible. focus
+    orders are re-read, and the result is sorted once. */
+    IWindow* focusedWindow = nullptr;
     if (focused >= 0 && (int) this->focusable.size() > focused) {
-        focusedWindow = this->focusable.at(focused);
+        focusedWindow = this->focusable[focused].window.get();
+    }
+
+    this->focusable.clear();
+    for (auto& window : this->children) {
+        int order = window->GetFocusOrder();
+        if (order >= 0 && window->IsVisible()) {
+            this->focusable.push_back({ order, window->GetId(), window });
+        }
     }
 
     std::sort(
         this->focusable.begin(),
         this->focusable.end(),
-        sortByFocusOrder);
+        sortByFocusOrder<FocusEntry>);
 
     if (focusedWindow) {
-        this->focused = find(this->focusable, focusedWindow);
-    }
-}
-
-void LayoutBase::RemoveFocusable(IWindowPtr window) {
-    std::vector<IWindowPtr>::iterator it = this->focusable.begin();
-    for (; it != this->focusable.end(); it++) {
-        if (*it == window) {
-            this->focusable.erase(it);
-            return;
-        }
+        this->focused = this->FindFocusable(focusedWindow);
     }
 }
 
@@ -260,12 +293,11 @@ bool LayoutBase::SetFocus(IWindowPtr focus) {
         return true;
     }
     else {
-        for (size_t i = 0; i < this->focusable.size(); i++) {
-            if (this->focusable[i] == focus) {
-                this->focused = i;
-                this->EnsureValidFocus();
-                return true;
-            }
+        int index = this->FindFocusable(focus.get());
+        if (index >= 0) {
+            this->focused = index;
+            this->EnsureValidFocus();
+            return true;
         }
     }
     return false;
@@ -337,7 +369,7 @@ IWindowPtr LayoutBase::FocusLast() {
 
 IWindowPtr LayoutBase::GetFocus() {
     if (this->focused >= 0 && (int) this->focusable.size() > this->focused) {
-        auto view = this->focusable[this->focused];
+        auto& view = this->focusable[this->focused].window;
         if (view->IsVisible()) {
             return view;
         }
@@ -363,7 +395,7 @@ int LayoutBase::GetFocusableCount() {
 }
 
 IWindowPtr LayoutBase::GetFocusableAt(int index) {
-    return this->focusable.at(index);
+    return this->focusable.at(index).window;
 }
 
 ILayout::FocusMode LayoutBase::GetFocusMode() const {
@@ -374,7 +406,7 @@ void LayoutBase::SetFocusMode(FocusMode mode) {
     this->focusMode = mode;
 }
 
-bool LayoutBase::KeyPress(const std::string& key) {
+bool LayoutBase::KeyPress(KeyId key) {
     auto& keys = NavigationKeys();
     if (keys.Left(key) || keys.Up(key)) {
         this->FocusPrev();
@@ -389,7 +421,33 @@ bool LayoutBase::KeyPress(const std::string& key) {
 }
 
 bool LayoutBase::MouseEvent(const IMouseHandler::Event& mouseEvent) {
-    for (auto window : this->children) {
+    /* the event is relative to our content area. if we're on screen, map
+    it back to screen space and ask the hit test index which of our children
+    are under it, topmost first. */
+    int left, top, width, height;
+    auto& index = Window::HitTest();
+
+    if (index.GetBounds(this, left, top, width, height)) {
+        int frameOffset = this->IsFrameVisible() ? 1 : 0;
+        std::vector<IWindow*> hits;
+        index.HitsAt(
+            mouseEvent.x + left + frameOffset,
+            mouseEvent.y + top + frameOffset,
+            hits);
+
+        for (auto window : hits) {
+            if (window->GetParent() == this) {
+                auto relative = IMouseHandler::Event(mouseEvent, window);
+                if (window->MouseEvent(relative)) {
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    for (auto& window : this->children) {
         auto x = window->GetX();
         auto y = window->GetY();
         auto cx = window->GetWidth();
@@ -404,4 +462,4 @@ bool LayoutBase::MouseEvent(const IMouseHandler::Event& mouseEvent) {
         }
     }
     return false;
-}
\ No newline at end of file
+}
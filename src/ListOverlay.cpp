@@ -34,17 +34,27 @@
 
 #include <algorithm>
 #include <functional>
+#include <random>
 #include <cursespp/ListOverlay.h>
+#include <cursespp/Draw.h>
 #include <cursespp/Scrollbar.h>
+#include <cursespp/SingleLineEntry.h>
 #include <cursespp/Colors.h>
 #include <cursespp/Screen.h>
 #include <cursespp/Text.h>
+#include <f8n/str/utf.h>
 
 using namespace cursespp;
+using namespace f8n::utf;
 
 #define VERTICAL_PADDING 2
 #define DEFAULT_WIDTH 26
 
+/* auto width: the narrowest we'll go, and how many rows from the middle
+of the list are measured in addition to the first and last pages */
+#define AUTO_WIDTH_MINIMUM 10
+#define AUTO_WIDTH_RANDOM_SAMPLES 64
+
 /* a little custom type that allows us to draw a scrollbar
 ourself, outside of the list window frame. */
 class ListOverlay::CustomListWindow : public ListWindow {
@@ -88,6 +98,11 @@ ListOverlay::ListOverlay() {
     this->SetContentColor(Color::OverlayContent);
 
     this->autoDismiss = true;
+    this->autoWidth = false;
+    this->generation = this->measuredGeneration = 0;
+    this->measuredCount = 0;
+    this->measuredAdapter = nullptr;
+    this->measuredWidth = -1;
 
     this->width = this->height = 0;
     this->setWidth = this->setWidthPercent = 0;
@@ -98,7 +113,10 @@ ListOverlay::ListOverlay() {
         }
     };
 
-    auto adapterChanged = [this] { this->Layout(); };
+    auto adapterChanged = [this] {
+        ++this->generation;
+        this->Layout();
+    };
 
     this->scrollbar.reset(new Window());
     this->scrollbar->SetFrameVisible(false);
@@ -171,6 +189,7 @@ ListOverlay& ListOverlay::SetTitle(const std::string& title) {
 ListOverlay& ListOverlay::SetWidth(int width) {
     this->setWidth = width;
     this->setWidthPercent = 0;
+    this->autoWidth = false;
 
     if (this->IsVisible()) {
         this->Layout();
@@ -182,6 +201,18 @@ ListOverlay& ListOverlay::SetWidth(int width) {
 ListOverlay& ListOverlay::SetWidthPercent(int percent) {
     this->setWidthPercent = percent;
     this->setWidth = 0;
+    this->autoWidth = false;
+
+    if (this->IsVisible()) {
+        this->Layout();
+    }
+
+    return *this;
+}
+
+ListOverlay& ListOverlay::SetAutoWidth(bool autoWidth) {
+    this->autoWidth = autoWidth;
+    this->setWidth = this->setWidthPercent = 0;
 
     if (this->IsVisible()) {
         this->Layout();
@@ -247,21 +278,21 @@ size_t ListOverlay::GetSelectedIndex() {
     return this->listWindow->GetSelectedIndex();
 }
 
-bool ListOverlay::KeyPress(const std::string& key) {
-    if (keyInterceptorCallback && keyInterceptorCallback(this, key)) {
+bool ListOverlay::KeyPress(KeyId key) {
+    if (keyInterceptorCallback && keyInterceptorCallback(this, key::Name(key))) {
         return true;
     }
-    else if (key == "^[") { /* esc closes */
+    else if (key == key::Escape) { /* esc closes */
         this->Dismiss();
         return true;
     }
-    else if (key == " ") { /* space bar also toggles activation */
+    else if (key == key::Space) { /* space bar also toggles activation */
         this->OnListEntryActivated(
             this->listWindow.get(),
             this->listWindow->GetSelectedIndex());
         return true;
     }
-    else if (key == "KEY_BACKSPACE" || key == "KEY_DC") {
+    else if (key == key::Backspace || key == key::Delete) {
         if (deleteKeyCallback) {
             deleteKeyCallback(
                 this,
@@ -293,6 +324,9 @@ void ListOverlay::RecalculateSize() {
         int cx = Screen::GetWidth();
         this->width = (int)((this->setWidthPercent / 100.0f) * cx);
     }
+    else if (this->autoWidth) {
+        this->width = this->MeasureContentWidth();
+    }
     else {
         this->width = this->setWidth > 0 ? this->setWidth : DEFAULT_WIDTH;
     }
@@ -314,6 +348,74 @@ void ListOverlay::RecalculateSize() {
     this->x = (Screen::GetWidth() / 2) - (this->width / 2);
 }
 
+int ListOverlay::MeasureContentWidth() {
+    IScrollAdapter* adapter = this->adapter.get();
+    size_t count = adapter ? adapter->GetEntryCount() : 0;
+
+    if (adapter != this->measuredAdapter ||
+        count != this->measuredCount ||
+        this->generation != this->measuredGeneration ||
+        this->measuredWidth < 0)
+    {
+        size_t widest = 0;
+        auto measured = dynamic_cast<IMeasuredAdapter*>(adapter);
+
+        if (measured) {
+            widest = measured->GetMaxEntryWidth();
+        }
+
+        if (widest == IMeasuredAdapter::Unknown) {
+            widest = 0;
+            measured = nullptr; /* sample it like any other adapter */
+        }
+
+        if (!measured && count > 0) {
+            /* never the whole list: the first and last pages (what the user
+            sees when scrolling to either end), plus a spread of rows from
+            the middle. stable across calls, so the width doesn't jitter. */
+            size_t page = (size_t) std::max(1, Screen::GetHeight());
+            std::vector<size_t> rows;
+
+            for (size_t i = 0; i < std::min(page, count); i++) {
+                rows.push_back(i);
+                rows.push_back(count - 1 - i);
+            }
+
+            if (count > page * 2) {
+                std::minstd_rand random((unsigned) count);
+                std::uniform_int_distribution<size_t> middle(page, count - page - 1);
+                for (size_t i = 0; i < AUTO_WIDTH_RANDOM_SAMPLES; i++) {
+                    rows.push_back(middle(random));
+                }
+            }
+
+            size_t unbounded = (size_t) Screen::GetWidth();
+            for (auto row : rows) {
+                auto entry = adapter->GetEntry(this->listWindow.get(), row);
+                auto single = dynamic_cast<SingleLineEntry*>(entry.get());
+                if (single) {
+                    widest = std::max(widest, u8cols(single->GetValue()));
+                }
+                else if (entry) {
+                    entry->SetWidth(unbounded);
+                    for (size_t i = 0; i < entry->GetLineCount(); i++) {
+                        widest = std::max(widest, u8cols(entry->GetLine(i)));
+                    }
+                }
+            }
+        }
+
+        this->measuredAdapter = adapter;
+        this->measuredCount = count;
+        this->measuredGeneration = this->generation;
+        this->measuredWidth = (int) std::max(widest, u8cols(this->title));
+    }
+
+    /* frame and padding on each side, and room for the scrollbar */
+    int scrollbar = ((int) count + 4 > Screen::GetHeight() - 4) ? 2 : 0;
+    return std::max(AUTO_WIDTH_MINIMUM, this->measuredWidth + 4 + scrollbar);
+}
+
 void ListOverlay::UpdateContents() {
     if (!this->IsVisible() || this->width <= 0 || this->height <= 0) {
         return;
@@ -327,7 +429,7 @@ void ListOverlay::UpdateContents() {
     if (this->title.size()) {
         wmove(c, currentY, currentX);
         wattron(c, A_BOLD);
-        checked_wprintw(c, text::Align(this->title, text::AlignCenter, this->width - 4).c_str());
+        draw::Aligned(c, this->title, text::AlignCenter, this->width - 4);
         wattroff(c, A_BOLD);
         currentY += 2;
     }
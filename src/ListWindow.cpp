@@ -294,14 +294,14 @@ void ListWindow::OnDimensionsChanged() {
     this->ScrollTo(this->GetScrollPosition().firstVisibleEntryIndex);
 }
 
-bool ListWindow::KeyPress(const std::string& key) {
-    if (key == "KEY_ENTER") {
+bool ListWindow::KeyPress(KeyId key) {
+    if (key == key::Enter) {
         auto selected = this->GetSelectedIndex();
         if (selected != NO_SELECTION) {
             this->OnEntryActivated(selected);
         }
     }
-    else if (key == "M-enter") {
+    else if (key == key::MetaEnter) {
         auto selected = this->GetSelectedIndex();
         if (selected != NO_SELECTION) {
             this->OnEntryContextMenu(selected);
@@ -0,0 +1,305 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <cursespp/NotificationCenter.h>
+#include <cursespp/App.h>
+#include <cursespp/ListOverlay.h>
+#include <cursespp/SimpleScrollAdapter.h>
+#include <cursespp/ToastOverlay.h>
+#include <cursespp/Window.h>
+#include <f8n/runtime/Message.h>
+#include <algorithm>
+#include <chrono>
+
+using namespace cursespp;
+using namespace f8n::runtime;
+using namespace std::chrono;
+
+#define MESSAGE_NOTIFICATIONS_POSTED 1
+#define MESSAGE_NOTIFICATIONS_TICK 2
+
+#define DEFAULT_DURATION_MS 3000
+#define DEFAULT_INTERVAL_MS 750
+#define DEFAULT_HISTORY_SIZE 200
+
+/* distinct notifications waiting to be shown. past this, the oldest are
+dropped (they're still in the history); nobody reads a backlog of toasts. */
+#define MAX_PENDING 16
+
+/* Post() may be called from any thread, so it can't use App::Now(), which
+may be backed by a virtual clock that belongs to the main thread. */
+static int64_t monotonicNow() {
+    return duration_cast<milliseconds>(
+        steady_clock::now().time_since_epoch()).count();
+}
+
+NotificationCenter::NotificationCenter()
+: showing(false)
+, dirty(false)
+, flushPosted(false)
+, hiding(false)
+, toastVisible(false)
+, shownAt(0)
+, durationMs(DEFAULT_DURATION_MS)
+, intervalMs(DEFAULT_INTERVAL_MS)
+, historySize(DEFAULT_HISTORY_SIZE) {
+}
+
+NotificationCenter::~NotificationCenter() {
+}
+
+void NotificationCenter::Post(const std::string& text, int durationMs) {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    int64_t now = monotonicNow();
+
+    if (!this->history.empty() && this->history.front().text == text) {
+        this->history.front().count++;
+        this->history.front().time = now;
+    }
+    else {
+        this->history.push_front({ text, 1, now, durationMs });
+        while (this->history.size() > this->historySize) {
+            this->history.pop_back();
+        }
+    }
+
+    if (this->showing && this->current.text == text) {
+        this->current.count++;
+        this->dirty = true;
+    }
+    else {
+        auto it = std::find_if(
+            this->pending.begin(),
+            this->pending.end(),
+            [&text](const Notification& n) { return n.text == text; });
+
+        if (it != this->pending.end()) {
+            it->count++;
+        }
+        else {
+            this->pending.push_back({ text, 1, now, durationMs });
+            while (this->pending.size() > MAX_PENDING) {
+                this->pending.pop_front();
+            }
+        }
+    }
+
+    /* a burst of posts turns into a single message for the main thread */
+    if (!this->flushPosted) {
+        this->flushPosted = true;
+        Window::MessageQueue().Post(
+            Message::Create(this, MESSAGE_NOTIFICATIONS_POSTED, 0, 0));
+    }
+}
+
+void NotificationCenter::SetDuration(int durationMs) {
+    this->durationMs = std::max(0, durationMs);
+}
+
+void NotificationCenter::SetInterval(int intervalMs) {
+    this->intervalMs = std::max(0, intervalMs);
+}
+
+void NotificationCenter::SetHistorySize(size_t size) {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->historySize = size;
+    while (this->history.size() > size) {
+        this->history.pop_back();
+    }
+}
+
+std::vector<NotificationCenter::Notification> NotificationCenter::History() {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    return std::vector<Notification>(this->history.begin(), this->history.end());
+}
+
+void NotificationCenter::ShowHistory(const std::string& title) {
+    std::shared_ptr<SimpleScrollAdapter> adapter(new SimpleScrollAdapter());
+    adapter->SetSelectable(true);
+
+    for (auto& notification : this->History()) {
+        adapter->AddEntry(Format(notification));
+    }
+
+    std::shared_ptr<ListOverlay> dialog(new ListOverlay());
+    dialog->SetAdapter(adapter)
+        .SetTitle(title)
+        .SetWidthPercent(80)
+        .SetSelectedIndex(0);
+
+    App::Overlays().Push(dialog);
+}
+
+void NotificationCenter::Reset() {
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->pending.clear();
+    }
+
+    this->Hide();
+}
+
+int NotificationCenter::DurationOf(const Notification& notification) {
+    return notification.durationMs < 0 ? this->durationMs : notification.durationMs;
+}
+
+std::string NotificationCenter::Format(const Notification& notification) {
+    if (notification.count > 1) {
+        return notification.text + " (x" + std::to_string(notification.count) + ")";
+    }
+    return notification.text;
+}
+
+void NotificationCenter::ShowNext() {
+    std::string text;
+    bool more;
+    int64_t durationMs;
+
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        if (this->pending.empty()) {
+            return;
+        }
+
+        this->current = this->pending.front();
+        this->pending.pop_front();
+        this->showing = true;
+        this->dirty = false;
+        this->shownAt = App::Now();
+        text = Format(this->current);
+        more = !this->pending.empty();
+        durationMs = this->DurationOf(this->current);
+    }
+
+    if (!this->toast) {
+        /* no timer of its own; we decide when it goes away */
+        this->toast.reset(new ToastOverlay(text, -1));
+        this->toast->Dismissed.connect(this, &NotificationCenter::OnToastDismissed);
+    }
+    else {
+        this->toast->SetText(text);
+    }
+
+    if (!this->toastVisible) {
+        this->toastVisible = true;
+        App::Overlays().Push(this->toast);
+    }
+
+    this->Schedule(more ? this->intervalMs : durationMs);
+}
+
+void NotificationCenter::Hide() {
+    Window::MessageQueue().Remove(this, MESSAGE_NOTIFICATIONS_TICK);
+
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->showing = false;
+    }
+
+    if (this->toast && this->toastVisible) {
+        this->hiding = true;
+        this->toast->Close();
+        this->hiding = false;
+    }
+
+    this->toastVisible = false;
+}
+
+void NotificationCenter::Schedule(int64_t delayMs) {
+    auto& queue = Window::MessageQueue();
+    queue.Remove(this, MESSAGE_NOTIFICATIONS_TICK);
+    queue.Post(
+        Message::Create(this, MESSAGE_NOTIFICATIONS_TICK, 0, 0),
+        std::max((int64_t) 0, delayMs));
+}
+
+void NotificationCenter::OnToastDismissed(ToastOverlay* toast) {
+    this->toastVisible = false;
+
+    if (!this->hiding) {
+        /* dismissed by the user; everything that was waiting goes too */
+        this->Reset();
+    }
+}
+
+void NotificationCenter::ProcessMessage(IMessage& message) {
+    int type = message.Type();
+
+    if (type == MESSAGE_NOTIFICATIONS_POSTED) {
+        bool showing, dirty, waiting;
+        std::string text;
+        int64_t durationMs;
+
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->flushPosted = false;
+            showing = this->showing;
+            dirty = this->dirty;
+            waiting = !this->pending.empty();
+            this->dirty = false;
+            text = Format(this->current);
+            durationMs = this->DurationOf(this->current);
+        }
+
+        if (!showing) {
+            this->ShowNext();
+        }
+        else {
+            if (dirty && this->toast) {
+                this->toast->SetText(text);
+            }
+
+            /* the current one stays up for at least an interval, and for the
+            full duration if nothing replaces it. */
+            int64_t elapsed = App::Now() - this->shownAt;
+            this->Schedule(waiting
+                ? this->intervalMs - elapsed
+                : durationMs - (dirty ? 0 : elapsed));
+        }
+    }
+    else if (type == MESSAGE_NOTIFICATIONS_TICK) {
+        bool waiting;
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            waiting = !this->pending.empty();
+        }
+
+        if (waiting) {
+            this->ShowNext();
+        }
+        else {
+            this->Hide();
+        }
+    }
+}
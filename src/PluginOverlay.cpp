@@ -37,6 +37,7 @@
 #include <f8n/environment/Environment.h>
 #include <f8n/environment/Filesystem.h>
 #include <f8n/plugins/Plugins.h>
+#include <f8n/runtime/Message.h>
 #include <f8n/sdk/ISchema.h>
 #include <f8n/i18n/Locale.h>
 #include <f8n/str/utf.h>
@@ -54,9 +55,12 @@
 #include <cursespp/Text.h>
 
 #include <algorithm>
+#include <atomic>
 #include <ostream>
 #include <iomanip>
 #include <limits>
+#include <map>
+#include <mutex>
 
 using namespace f8n;
 using namespace f8n::env;
@@ -65,14 +69,19 @@ using namespace f8n::prefs;
 using namespace f8n::plugin;
 using namespace f8n::i18n;
 using namespace f8n::utf;
+using namespace f8n::runtime;
 using namespace cursespp;
 
+#define MESSAGE_PLUGINS_FOUND 1
+#define MESSAGE_SCHEMAS_LOADED 2
+#define PLACEHOLDER_ROWS 3
+
 static const std::string unchecked = "[ ]";
 static const std::string checked = "[x]";
 
 struct PluginInfo {
     IPlugin* plugin;
-    std::string fn;
+    std::string name, guid, fn, sortKey;
     bool enabled;
 };
 
@@ -81,6 +90,7 @@ using PluginList = std::vector<PluginInfoPtr>;
 using PrefsPtr = std::shared_ptr<Preferences>;
 using SinglePtr = std::shared_ptr<SingleLineEntry>;
 using SchemaPtr = std::shared_ptr<ISchema>;
+using SchemaMap = std::map<std::string, SchemaPtr>;
 
 static size_t DEFAULT_INPUT_WIDTH = 26;
 static size_t MINIMUM_OVERLAY_WIDTH = 16;
@@ -114,55 +124,95 @@ static void showNoSchemaDialog(const std::string& name) {
     App::Overlays().Push(dialog);
 }
 
-class PluginListAdapter : public ScrollAdapterBase {
+/* plugins are enumerated (and their schemas fetched) on a background thread,
+so the overlay opens right away. the worker shares nothing with the adapter
+but this state, and only posts to the adapter while it's still alive. once
+the adapter is gone the worker skips whatever is left; the app joins it at
+shutdown (see App::RunInBackground()). */
+struct PluginLoadState {
+    std::mutex mutex;
+    PluginList found;
+    SchemaMap schemas;
+    std::atomic<bool> cancelled{ false }; /* set with mutex held */
+    bool posted{ false }, enumerated{ false };
+};
+
+using PluginLoadStatePtr = std::shared_ptr<PluginLoadState>;
+
+static std::string sortKey(const std::string& input) {
+    std::string name = input;
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+    return name;
+}
+
+class PluginListAdapter : public ScrollAdapterBase, public IMessageTarget {
     public:
         PluginListAdapter() {
             this->prefs = Preferences::ForComponent("plugins");
-            this->Refresh();
+            this->state = std::make_shared<PluginLoadState>();
+            this->loading = true;
+            this->schemasLoaded = false;
+            this->Load();
         }
 
         virtual ~PluginListAdapter() {
+            {
+                std::unique_lock<std::mutex> lock(this->state->mutex);
+                this->state->cancelled = true;
+            }
+
+            Window::MessageQueue().Remove(this);
             this->prefs->Save();
         }
 
-        void configure(size_t index) {
-            SchemaPtr schema;
-
-            using Deleter = Plugins::ReleaseDeleter<ISchema>;
-            std::string guid = plugins[index]->plugin->Guid();
-            Plugins::Instance().QueryInterface<ISchema, Deleter>(
-                "GetSchema",
-                [guid, &schema](IPlugin* raw, SchemaPtr plugin, const std::string& fn) {
-                    if (raw->Guid() == guid) {
-                        schema = plugin;
-                    }
-                });
+        void SetOverlay(std::weak_ptr<ListOverlay> overlay) {
+            this->overlay = overlay;
+        }
 
-            if (schema) {
-                showConfigureOverlay(plugins[index]->plugin, schema);
+        void configure(size_t index) {
+            if (index >= this->plugins.size()) {
+                return;
             }
-            else {
-                showNoSchemaDialog(plugins[index]->plugin->Name());
+
+            /* schemas are still being fetched; open it when they arrive */
+            if (!this->schemasLoaded) {
+                this->pendingConfigure = this->plugins[index];
+                return;
             }
+
+            this->Configure(this->plugins[index]);
         }
 
         void toggleEnabled(size_t index) {
+            if (index >= this->plugins.size()) {
+                return;
+            }
+
             PluginInfoPtr plugin = this->plugins.at(index);
             plugin->enabled = !plugin->enabled;
             this->prefs->SetBool(plugin->fn, plugin->enabled);
         }
 
         virtual size_t GetEntryCount() override {
+            if (this->loading && this->plugins.empty()) {
+                return PLACEHOLDER_ROWS;
+            }
             return plugins.size();
         }
 
         virtual EntryPtr GetEntry(cursespp::ScrollableWindow* window, size_t index) override {
+            if (index >= this->plugins.size()) {
+                SinglePtr result = SinglePtr(new SingleLineEntry(" " + unchecked + " ..."));
+                result->SetAttrs(Color(Color::TextDisabled));
+                return result;
+            }
+
             PluginInfoPtr info = plugins.at(index);
 
             std::string display =
                 " " +
                 (info->enabled ? checked : unchecked) + " " +
-                info->plugin->Name() + " (" + info->fn + ")";
+                info->name + " (" + info->fn + ")";
 
             SinglePtr result = SinglePtr(new SingleLineEntry(text::Ellipsize(display, this->GetWidth())));
 
@@ -174,39 +224,171 @@ class PluginListAdapter : public ScrollAdapterBase {
             return result;
         }
 
+        virtual void ProcessMessage(IMessage& message) override {
+            if (message.Type() == MESSAGE_PLUGINS_FOUND) {
+                PluginList found;
+                bool enumerated;
+
+                {
+                    std::unique_lock<std::mutex> lock(this->state->mutex);
+                    found.swap(this->state->found);
+                    enumerated = this->state->enumerated;
+                    this->state->posted = false;
+                }
+
+                this->Merge(found);
+                this->loading = !enumerated;
+                this->Changed();
+            }
+            else if (message.Type() == MESSAGE_SCHEMAS_LOADED) {
+                {
+                    std::unique_lock<std::mutex> lock(this->state->mutex);
+                    this->schemas.swap(this->state->schemas);
+                }
+
+                this->schemasLoaded = true;
+
+                if (this->pendingConfigure) {
+                    auto plugin = this->pendingConfigure;
+                    this->pendingConfigure.reset();
+                    this->Configure(plugin);
+                }
+            }
+        }
+
     private:
-        static std::string SortKey(const std::string& input) {
-            std::string name = input;
-            std::transform(name.begin(), name.end(), name.begin(), ::tolower);
-            return name;
+        void Load() {
+            auto state = this->state;
+            auto target = this;
+
+            /* only ever called with the state lock held, so the adapter
+            can't be destroyed between the check and the post. */
+            auto post = [state, target](int type) {
+                if (!state->cancelled) {
+                    Window::MessageQueue().Post(Message::Create(target, type, 0, 0));
+                }
+            };
+
+            App::RunInBackground([state, post] {
+                using PluginDeleter = Plugins::NullDeleter<IPlugin>;
+                using SchemaDeleter = Plugins::ReleaseDeleter<ISchema>;
+                using Plugin = std::shared_ptr<IPlugin>;
+
+                /* results are streamed to the ui as they're found. a single
+                message covers everything found until the ui picks it up. */
+                Plugins::Instance().QueryInterface<IPlugin, PluginDeleter>(
+                    "GetPlugin",
+                    [state, post](IPlugin* raw, Plugin plugin, const std::string& fn) {
+                        if (state->cancelled) {
+                            return; /* nobody to show it to */
+                        }
+
+                        PluginInfoPtr info(new PluginInfo());
+                        info->plugin = raw;
+                        info->name = raw->Name();
+                        info->guid = raw->Guid();
+                        info->fn = fs::Filename(fn);
+                        info->sortKey = sortKey(info->name);
+                        info->enabled = true;
+
+                        std::unique_lock<std::mutex> lock(state->mutex);
+                        state->found.push_back(info);
+                        if (!state->posted) {
+                            state->posted = true;
+                            post(MESSAGE_PLUGINS_FOUND);
+                        }
+                    });
+
+                {
+                    std::unique_lock<std::mutex> lock(state->mutex);
+                    state->enumerated = true;
+                    state->posted = true;
+                    post(MESSAGE_PLUGINS_FOUND);
+                    if (state->cancelled) {
+                        return;
+                    }
+                }
+
+                SchemaMap schemas;
+
+                Plugins::Instance().QueryInterface<ISchema, SchemaDeleter>(
+                    "GetSchema",
+                    [state, &schemas](IPlugin* raw, SchemaPtr schema, const std::string& fn) {
+                        if (!state->cancelled) {
+                            schemas[raw->Guid()] = schema;
+                        }
+                    });
+
+                std::unique_lock<std::mutex> lock(state->mutex);
+                state->schemas.swap(schemas);
+                post(MESSAGE_SCHEMAS_LOADED);
+            });
         }
 
-        void Refresh() {
-            plugins.clear();
+        /* inserts newly found plugins in sorted order, keeping the
+        selection on the same plugin */
+        void Merge(PluginList& found) {
+            if (found.empty()) {
+                return;
+            }
+
+            for (auto& info : found) {
+                info->enabled = this->prefs->GetBool(info->fn, true);
+            }
 
-            PluginList& plugins = this->plugins;
-            auto prefs = this->prefs;
+            auto overlay = this->overlay.lock();
 
-            using Deleter = Plugins::NullDeleter<IPlugin>;
-            using Plugin = std::shared_ptr<IPlugin>;
+            PluginInfoPtr selected;
+            if (overlay) {
+                size_t index = overlay->GetSelectedIndex();
+                if (index < this->plugins.size()) {
+                    selected = this->plugins[index];
+                }
+            }
 
-            Plugins::Instance().QueryInterface<IPlugin, Deleter>(
-                "GetPlugin",
-                [&plugins, prefs](IPlugin* raw, Plugin plugin, const std::string& fn) {
-                    PluginInfoPtr info(new PluginInfo());
-                    info->plugin = raw;
-                    info->fn = fs::Filename(fn);
-                    info->enabled = prefs->GetBool(info->fn, true);
-                    plugins.push_back(info);
-                });
+            auto compare = [](const PluginInfoPtr& p1, const PluginInfoPtr& p2) -> bool {
+                return p1->sortKey < p2->sortKey;
+            };
+
+            std::sort(found.begin(), found.end(), compare);
+            size_t middle = this->plugins.size();
+            this->plugins.insert(this->plugins.end(), found.begin(), found.end());
+            std::inplace_merge(
+                this->plugins.begin(),
+                this->plugins.begin() + middle,
+                this->plugins.end(),
+                compare);
+
+            if (overlay && selected) {
+                auto it = std::find(this->plugins.begin(), this->plugins.end(), selected);
+                overlay->SetSelectedIndex((size_t) (it - this->plugins.begin()));
+            }
+        }
 
-            std::sort(plugins.begin(), plugins.end(), [](PluginInfoPtr p1, PluginInfoPtr p2) -> bool {
-                return SortKey(p1->plugin->Name()) < SortKey(p2->plugin->Name());
-            });
+        void Changed() {
+            auto overlay = this->overlay.lock();
+            if (overlay) {
+                overlay->RefreshAdapter();
+            }
+        }
+
+        void Configure(PluginInfoPtr info) {
+            auto it = this->schemas.find(info->guid);
+            if (it != this->schemas.end() && it->second) {
+                showConfigureOverlay(info->plugin, it->second);
+            }
+            else {
+                showNoSchemaDialog(info->name);
+            }
         }
 
         std::shared_ptr<Preferences> prefs;
+        std::weak_ptr<ListOverlay> overlay;
+        PluginLoadStatePtr state;
         PluginList plugins;
+        SchemaMap schemas;
+        PluginInfoPtr pendingConfigure;
+        bool loading, schemasLoaded;
 };
 
 PluginOverlay::PluginOverlay() {
@@ -238,5 +420,7 @@ void PluginOverlay::Show() {
                 pluginAdapter->configure(index);
             });
 
+    pluginAdapter->SetOverlay(dialog);
+
     cursespp::App::Overlays().Push(dialog);
 }
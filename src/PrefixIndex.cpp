@@ -0,0 +1,244 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <cursespp/PrefixIndex.h>
+#include <algorithm>
+#include <iterator>
+
+using namespace cursespp;
+
+using Suggestion = IAutocompleteProvider::Suggestion;
+using Suggestions = IAutocompleteProvider::Suggestions;
+
+#define CANCEL_CHECK_INTERVAL 4096
+
+static inline char fold(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char) (c + ('a' - 'A')) : c;
+}
+
+/* case-insensitive ordering, with a case-sensitive tie break so that values
+differing only by case have a stable order */
+static inline int compare(const std::string& a, const std::string& b) {
+    size_t count = std::min(a.size(), b.size());
+    for (size_t i = 0; i < count; i++) {
+        char ca = fold(a[i]), cb = fold(b[i]);
+        if (ca != cb) {
+            return (unsigned char) ca < (unsigned char) cb ? -1 : 1;
+        }
+    }
+    if (a.size() != b.size()) {
+        return a.size() < b.size() ? -1 : 1;
+    }
+    return a.compare(b);
+}
+
+/* compares only the first prefix.size() characters of `value` */
+static inline int comparePrefix(const std::string& value, const std::string& prefix) {
+    size_t count = std::min(value.size(), prefix.size());
+    for (size_t i = 0; i < count; i++) {
+        char cv = fold(value[i]), cp = fold(prefix[i]);
+        if (cv != cp) {
+            return (unsigned char) cv < (unsigned char) cp ? -1 : 1;
+        }
+    }
+    return value.size() < prefix.size() ? -1 : 0;
+}
+
+/* true if `a` should be suggested ahead of `b` */
+static inline bool ranksAhead(const Suggestion& a, const Suggestion& b) {
+    if (a.score != b.score) {
+        return a.score > b.score;
+    }
+    if (a.value.size() != b.value.size()) {
+        return a.value.size() < b.value.size();
+    }
+    return compare(a.value, b.value) < 0;
+}
+
+static bool lessThan(const Suggestion& a, const Suggestion& b) {
+    return compare(a.value, b.value) < 0;
+}
+
+/* collapses adjacent duplicates in a sorted array, keeping the best score */
+static void collapse(Suggestions& entries) {
+    size_t out = 0;
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (out > 0 && entries[out - 1].value == entries[i].value) {
+            entries[out - 1].score = std::max(entries[out - 1].score, entries[i].score);
+        }
+        else {
+            if (out != i) {
+                entries[out] = std::move(entries[i]);
+            }
+            ++out;
+        }
+    }
+
+    entries.resize(out);
+}
+
+PrefixIndex::PrefixIndex()
+: entries(std::make_shared<const Suggestions>())
+, clears(0) {
+}
+
+PrefixIndex::~PrefixIndex() {
+}
+
+void PrefixIndex::Reserve(size_t count) {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->added.reserve(count);
+}
+
+void PrefixIndex::Add(const std::string& value, int64_t score) {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->added.push_back({ value, score });
+}
+
+void PrefixIndex::Clear() {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->entries = std::make_shared<const Suggestions>();
+    this->added.clear();
+    ++this->clears;
+}
+
+size_t PrefixIndex::Size() {
+    return this->Snapshot()->size();
+}
+
+PrefixIndex::SnapshotPtr PrefixIndex::Snapshot() {
+    SnapshotPtr snapshot;
+    Suggestions batch;
+    size_t clears;
+
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        snapshot = this->entries;
+        clears = this->clears;
+        batch.swap(this->added);
+    }
+
+    if (batch.empty()) {
+        return snapshot;
+    }
+
+    /* sort only the new values, then merge them into a copy of the sorted
+    array. none of this holds the lock, so Add() never waits on it. */
+    std::sort(batch.begin(), batch.end(), lessThan);
+    collapse(batch);
+
+    auto merged = std::make_shared<Suggestions>();
+    merged->reserve(snapshot->size() + batch.size());
+    std::merge(
+        snapshot->begin(), snapshot->end(),
+        batch.begin(), batch.end(),
+        std::back_inserter(*merged),
+        lessThan);
+    collapse(*merged);
+
+    std::unique_lock<std::mutex> lock(this->mutex);
+
+    if (this->clears == clears) {
+        if (this->entries == snapshot) {
+            this->entries = merged;
+        }
+        else {
+            /* another query published first; ours goes in the next merge */
+            this->added.insert(this->added.end(), batch.begin(), batch.end());
+        }
+    }
+
+    return merged;
+}
+
+void PrefixIndex::Suggest(
+    const std::string& query,
+    size_t limit,
+    const std::atomic<bool>& cancelled,
+    Suggestions& results)
+{
+    results.clear();
+
+    if (limit == 0) {
+        return;
+    }
+
+    auto snapshot = this->Snapshot();
+    auto& entries = *snapshot;
+
+    auto begin = std::lower_bound(
+        entries.begin(), entries.end(), query,
+        [](const Suggestion& entry, const std::string& prefix) {
+            return comparePrefix(entry.value, prefix) < 0;
+        });
+
+    auto end = std::upper_bound(
+        begin, entries.end(), query,
+        [](const std::string& prefix, const Suggestion& entry) {
+            return comparePrefix(entry.value, prefix) > 0;
+        });
+
+    /* keep the best `limit` matches in a heap whose top is the worst of
+    them, so each remaining candidate is a single compare to reject */
+    std::vector<const Suggestion*> best;
+    best.reserve(std::min(limit, (size_t) (end - begin)) + 1);
+
+    auto worstFirst = [](const Suggestion* a, const Suggestion* b) {
+        return ranksAhead(*a, *b);
+    };
+
+    size_t checked = 0;
+    for (auto it = begin; it != end; ++it) {
+        if (++checked % CANCEL_CHECK_INTERVAL == 0 && cancelled.load()) {
+            return;
+        }
+
+        if (best.size() < limit) {
+            best.push_back(&(*it));
+            std::push_heap(best.begin(), best.end(), worstFirst);
+        }
+        else if (ranksAhead(*it, *best.front())) {
+            std::pop_heap(best.begin(), best.end(), worstFirst);
+            best.back() = &(*it);
+            std::push_heap(best.begin(), best.end(), worstFirst);
+        }
+    }
+
+    std::sort_heap(best.begin(), best.end(), worstFirst);
+
+    results.reserve(best.size());
+    for (auto suggestion : best) {
+        results.push_back(*suggestion);
+    }
+}
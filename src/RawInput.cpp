@@ -0,0 +1,567 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <cursespp/curses_config.h>
+#include <cursespp/RawInput.h>
+#include <cursespp/Text.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+
+#ifndef WIN32
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+using namespace cursespp;
+using namespace std::chrono;
+
+/* how long to wait for the rest of a sequence after an ESC (or a partial
+sequence) before treating what we have as complete. matches set_escdelay(). */
+#define ESCAPE_DELAY_MS 20
+#define READ_CHUNK_SIZE (64 * 1024)
+#define DOUBLE_CLICK_MS 300
+
+static const std::string PASTE_END = "\x1b[201~";
+
+/* final byte -> key, for CSI (e.g. ESC [ A, ESC [ 1 ; 5 A) and SS3 (ESC O A) */
+static const std::unordered_map<unsigned char, std::string> FINAL_KEYS = {
+    { 'A', "KEY_UP" },
+    { 'B', "KEY_DOWN" },
+    { 'C', "KEY_RIGHT" },
+    { 'D', "KEY_LEFT" },
+    { 'H', "KEY_HOME" },
+    { 'F', "KEY_END" },
+    { 'Z', "KEY_BTAB" },
+    { 'P', "KEY_F(1)" },
+    { 'Q', "KEY_F(2)" },
+    { 'R', "KEY_F(3)" },
+    { 'S', "KEY_F(4)" },
+    { 'M', "KEY_ENTER" }, /* SS3 keypad enter */
+};
+
+/* numeric parameter -> key, for ESC [ n ~ */
+static const std::unordered_map<int, std::string> TILDE_KEYS = {
+    { 1, "KEY_HOME" },
+    { 2, "KEY_IC" },
+    { 3, "KEY_DC" },
+    { 4, "KEY_END" },
+    { 5, "KEY_PPAGE" },
+    { 6, "KEY_NPAGE" },
+    { 7, "KEY_HOME" },
+    { 8, "KEY_END" },
+    { 11, "KEY_F(1)" },
+    { 12, "KEY_F(2)" },
+    { 13, "KEY_F(3)" },
+    { 14, "KEY_F(4)" },
+    { 15, "KEY_F(5)" },
+    { 17, "KEY_F(6)" },
+    { 18, "KEY_F(7)" },
+    { 19, "KEY_F(8)" },
+    { 20, "KEY_F(9)" },
+    { 21, "KEY_F(10)" },
+    { 23, "KEY_F(11)" },
+    { 24, "KEY_F(12)" },
+};
+
+/* (key, xterm modifier) -> key, for the modified keys curses knows about.
+modifier values are 1 + (shift ? 1 : 0) + (alt ? 2 : 0) + (ctrl ? 4 : 0). */
+static const std::unordered_map<std::string, std::string> MODIFIED_KEYS = {
+    { "KEY_UP;2", "KEY_SR" },
+    { "KEY_DOWN;2", "KEY_SF" },
+    { "KEY_LEFT;2", "KEY_SLEFT" },
+    { "KEY_RIGHT;2", "KEY_SRIGHT" },
+    { "KEY_UP;3", "M-up" },
+    { "KEY_DOWN;3", "M-down" },
+    { "KEY_UP;5", "CTL_UP" },
+    { "KEY_DOWN;5", "CTL_DOWN" },
+    { "KEY_DC;2", "KEY_SDC" },
+    { "KEY_HOME;2", "KEY_SHOME" },
+    { "KEY_END;2", "KEY_SEND" },
+};
+
+static inline int64_t now() {
+    return duration_cast<milliseconds>(
+        steady_clock::now().time_since_epoch()).count();
+}
+
+static std::string controlName(unsigned char c) {
+    /* same as keyname() for the C0 range and DEL */
+    if (c == 0x7f) {
+        return "^?";
+    }
+    std::string result = "^";
+    result += (char)(c + '@');
+    return result;
+}
+
+static inline bool isControl(unsigned char c) {
+    return c < 0x20 || c == 0x7f;
+}
+
+static size_t utf8Length(unsigned char lead) {
+    if (lead >= 0xc2 && lead <= 0xdf) { return 2; }
+    if (lead >= 0xe0 && lead <= 0xef) { return 3; }
+    if (lead >= 0xf0 && lead <= 0xf4) { return 4; }
+    return 0;
+}
+
+static void parseParams(const std::string& params, std::vector<int>& target) {
+    target.clear();
+    const char* p = params.c_str();
+    while (*p) {
+        char* end = nullptr;
+        long value = strtol(p, &end, 10);
+        target.push_back((end == p) ? 0 : (int) value);
+        p = (*end == ';') ? end + 1 : end;
+        if (end == p && *p) {
+            ++p; /* skip anything unexpected */
+        }
+    }
+}
+
+RawInput::RawInput(int fd)
+: fd(fd)
+, started(false)
+, position(0)
+, state(Ground)
+, utf8Remaining(0)
+, pressedButton(-1)
+, lastClickButton(-1)
+, lastClickTime(0) {
+}
+
+RawInput::~RawInput() {
+    this->Stop();
+}
+
+void RawInput::Start(bool mouse) {
+    if (!this->started) {
+#ifndef WIN32
+        /* bracketed paste, plus button-event mouse tracking with SGR
+        (extended, unambiguous) coordinates. */
+        std::string enable = "\x1b[?2004h";
+        if (mouse) {
+            enable += "\x1b[?1000h\x1b[?1006h";
+        }
+        ssize_t written = write(STDOUT_FILENO, enable.c_str(), enable.size());
+        (void) written;
+#endif
+        this->started = true;
+    }
+}
+
+void RawInput::Stop() {
+    if (this->started) {
+#ifndef WIN32
+        static const std::string disable = "\x1b[?1006l\x1b[?1000l\x1b[?2004l";
+        ssize_t written = write(STDOUT_FILENO, disable.c_str(), disable.size());
+        (void) written;
+#endif
+        this->started = false;
+    }
+}
+
+void RawInput::Feed(const char* data, size_t length) {
+    /* compact consumed input before growing the buffer */
+    if (this->position > 0 && this->position >= this->input.size() / 2) {
+        this->input.erase(0, this->position);
+        this->position = 0;
+    }
+    this->input.append(data, length);
+}
+
+size_t RawInput::Fill(int timeoutMs) {
+#ifdef WIN32
+    return 0;
+#else
+    struct pollfd pfd;
+    pfd.fd = this->fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    if (poll(&pfd, 1, timeoutMs) <= 0 || !(pfd.revents & POLLIN)) {
+        return 0;
+    }
+
+    char buffer[READ_CHUNK_SIZE];
+    ssize_t count = read(this->fd, buffer, sizeof(buffer));
+
+    if (count <= 0) {
+        return 0;
+    }
+
+    this->Feed(buffer, (size_t) count);
+    return (size_t) count;
+#endif
+}
+
+bool RawInput::Read(Event& target, int timeoutMs) {
+    int wait = timeoutMs;
+
+    while (true) {
+        if (this->Next(target)) {
+            return true;
+        }
+
+        /* mid-sequence: only wait briefly for the rest of it. a paste can
+        take a while to arrive, so it gets the full timeout. */
+        if (this->state != Ground && this->state != Pasting) {
+            wait = ESCAPE_DELAY_MS;
+        }
+
+        if (this->Fill(wait) == 0) {
+            if (this->state != Ground && this->state != Pasting) {
+                return this->Flush(target);
+            }
+            return false;
+        }
+
+        /* data arrived; anything after this is a continuation */
+        wait = std::min(wait, ESCAPE_DELAY_MS);
+    }
+}
+
+bool RawInput::Next(Event& target) {
+    while (this->position < this->input.size()) {
+        if (this->state == Pasting) {
+            if (this->PasteChunk(target)) {
+                return true;
+            }
+            if (this->state == Pasting) {
+                return false; /* need more input */
+            }
+            continue;
+        }
+
+        unsigned char c = (unsigned char) this->input[this->position++];
+        if (this->Step(c, target)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool RawInput::PasteChunk(Event& target) {
+    size_t end = this->input.find(PASTE_END, this->position);
+
+    if (end != std::string::npos) {
+        this->paste.append(this->input, this->position, end - this->position);
+        this->position = end + PASTE_END.size();
+        this->state = Ground;
+
+        target = Event();
+        target.type = Event::Paste;
+        target.text.swap(this->paste);
+        return true;
+    }
+
+    /* keep enough of the tail around to recognize a terminator that is
+    split across reads */
+    size_t available = this->input.size() - this->position;
+    if (available > PASTE_END.size()) {
+        size_t take = available - PASTE_END.size();
+        this->paste.append(this->input, this->position, take);
+        this->position += take;
+    }
+
+    return false;
+}
+
+bool RawInput::Flush(Event& target) {
+    State previous = this->state;
+    this->state = Ground;
+
+    if (previous == Escape) {
+        return this->EmitKey("^[", target);
+    }
+
+    /* an incomplete CSI/SS3/UTF-8/mouse sequence. nothing sensible to
+    deliver; drop it. */
+    this->sequence.clear();
+    return false;
+}
+
+bool RawInput::EmitKey(const std::string& name, Event& target) {
+    target = Event();
+    target.type = Event::Key;
+    target.name = key::Normalize(name);
+    target.id = key::Intern(target.name);
+    return true;
+}
+
+bool RawInput::Step(unsigned char c, Event& target) {
+    switch (this->state) {
+        case Ground: {
+            if (c == 0x1b) {
+                this->state = Escape;
+                return false;
+            }
+            else if (isControl(c)) {
+                return this->EmitKey(controlName(c), target);
+            }
+            else if (c < 0x80) {
+                return this->EmitKey(std::string(1, (char) c), target);
+            }
+
+            size_t length = utf8Length(c);
+            if (length) {
+                this->sequence.assign(1, (char) c);
+                this->utf8Remaining = length - 1;
+                this->state = Utf8;
+            }
+            return false; /* stray continuation byte or invalid lead */
+        }
+
+        case Utf8: {
+            if ((c & 0xc0) != 0x80) {
+                /* malformed; drop the partial character and start over */
+                this->state = Ground;
+                --this->position;
+                return false;
+            }
+
+            this->sequence += (char) c;
+            if (--this->utf8Remaining == 0) {
+                this->state = Ground;
+                return this->EmitKey(this->sequence, target);
+            }
+            return false;
+        }
+
+        case Escape: {
+            if (c == '[') {
+                this->sequence.clear();
+                this->state = Csi;
+                return false;
+            }
+            else if (c == 'O') {
+                this->state = Ss3;
+                return false;
+            }
+
+            this->state = Ground;
+
+            if (c == 0x1b) {
+                /* ESC ESC: deliver the first, the second starts anew */
+                this->state = Escape;
+                return this->EmitKey("^[", target);
+            }
+            else if (isControl(c)) {
+                return this->EmitKey("M-" + controlName(c), target);
+            }
+            else if (c < 0x80) {
+                return this->EmitKey("M-" + std::string(1, (char) c), target);
+            }
+
+            /* ESC followed by a non-ASCII character; deliver both */
+            --this->position;
+            return this->EmitKey("^[", target);
+        }
+
+        case Csi: {
+            if (c >= 0x40 && c <= 0x7e) {
+                this->state = Ground;
+
+                if (c == 'M' && this->sequence.empty()) {
+                    this->state = MouseX10; /* 3 raw bytes follow */
+                    return false;
+                }
+
+                bool result = this->DispatchCsi(c, target);
+                this->sequence.clear();
+                return result;
+            }
+            else if (c >= 0x20 && c <= 0x3f) {
+                this->sequence += (char) c;
+                return false;
+            }
+
+            /* not a valid CSI byte; abandon the sequence */
+            this->sequence.clear();
+            this->state = Ground;
+            return false;
+        }
+
+        case Ss3: {
+            this->state = Ground;
+            return this->DispatchSs3(c, target);
+        }
+
+        case MouseX10: {
+            this->sequence += (char) c;
+            if (this->sequence.size() == 3) {
+                int button = (unsigned char) this->sequence[0] - 32;
+                int x = (unsigned char) this->sequence[1] - 33;
+                int y = (unsigned char) this->sequence[2] - 33;
+                this->sequence.clear();
+                this->state = Ground;
+
+                bool release = (button & 3) == 3 && !(button & 64);
+                if (release) {
+                    button = (this->pressedButton >= 0) ? this->pressedButton : 0;
+                }
+                return this->DispatchMouse(button, x, y, release, target);
+            }
+            return false;
+        }
+
+        case Pasting:
+            break; /* handled in bulk by PasteChunk() */
+    }
+
+    return false;
+}
+
+bool RawInput::DispatchCsi(unsigned char final, Event& target) {
+    const std::string& params = this->sequence;
+
+    /* SGR mouse: ESC [ < b ; x ; y (M|m) */
+    if (params.size() && params[0] == '<' && (final == 'M' || final == 'm')) {
+        std::vector<int> values;
+        parseParams(params.substr(1), values);
+        if (values.size() == 3) {
+            return this->DispatchMouse(
+                values[0], values[1] - 1, values[2] - 1, final == 'm', target);
+        }
+        return false;
+    }
+
+    std::vector<int> values;
+    parseParams(params, values);
+    int modifier = (values.size() >= 2) ? values[1] : 1;
+
+    std::string name;
+
+    if (final == '~') {
+        int number = values.size() ? values[0] : 0;
+
+        if (number == 200) {
+            this->paste.clear();
+            this->state = Pasting;
+            return false;
+        }
+
+        auto it = TILDE_KEYS.find(number);
+        if (it == TILDE_KEYS.end()) {
+            return false;
+        }
+        name = it->second;
+    }
+    else {
+        auto it = FINAL_KEYS.find(final);
+        if (it == FINAL_KEYS.end() || final == 'M') {
+            return false;
+        }
+        name = it->second;
+    }
+
+    if (modifier > 1) {
+        auto it = MODIFIED_KEYS.find(name + ";" + std::to_string(modifier));
+        if (it != MODIFIED_KEYS.end()) {
+            name = it->second;
+        }
+    }
+
+    return this->EmitKey(name, target);
+}
+
+bool RawInput::DispatchSs3(unsigned char final, Event& target) {
+    auto it = FINAL_KEYS.find(final);
+    if (it != FINAL_KEYS.end()) {
+        return this->EmitKey(it->second, target);
+    }
+    return false;
+}
+
+bool RawInput::DispatchMouse(int button, int x, int y, bool release, Event& target) {
+    mmask_t state = 0;
+    int index = button & 3;
+
+    if (button & 64) { /* wheel */
+#ifdef BUTTON5_PRESSED
+        state = (index == 0) ? BUTTON4_PRESSED : BUTTON5_PRESSED;
+#else
+        state = BUTTON4_PRESSED;
+#endif
+    }
+    else if (button & 32) { /* motion */
+        state = REPORT_MOUSE_POSITION;
+    }
+    else if (!release) {
+        static const mmask_t PRESSED[] = {
+            BUTTON1_PRESSED, BUTTON2_PRESSED, BUTTON3_PRESSED, BUTTON1_PRESSED };
+        state = PRESSED[index];
+        this->pressedButton = index;
+    }
+    else {
+        /* curses reports press+release as a click; handlers rely on that. */
+        static const mmask_t RELEASED[] = {
+            BUTTON1_RELEASED | BUTTON1_CLICKED,
+            BUTTON2_RELEASED | BUTTON2_CLICKED,
+            BUTTON3_RELEASED | BUTTON3_CLICKED,
+            BUTTON1_RELEASED | BUTTON1_CLICKED };
+
+        static const mmask_t DOUBLE_CLICKED[] = {
+            BUTTON1_DOUBLE_CLICKED, BUTTON2_DOUBLE_CLICKED,
+            BUTTON3_DOUBLE_CLICKED, BUTTON1_DOUBLE_CLICKED };
+
+        int64_t time = now();
+        if (index == this->lastClickButton && time - this->lastClickTime < DOUBLE_CLICK_MS) {
+            state = DOUBLE_CLICKED[index];
+            this->lastClickButton = -1;
+        }
+        else {
+            state = RELEASED[index];
+            this->lastClickButton = index;
+            this->lastClickTime = time;
+        }
+
+        this->pressedButton = -1;
+    }
+
+    target = Event();
+    target.type = Event::Mouse;
+    target.name = "KEY_MOUSE";
+    target.id = key::Mouse;
+    target.x = std::max(0, x);
+    target.y = std::max(0, y);
+    target.state = (int64_t) state;
+    return true;
+}
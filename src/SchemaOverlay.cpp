@@ -123,12 +123,47 @@ class StringListAdapter : public ScrollAdapterBase {
         std::vector<std::string> items;
 };
 
+/* the overlays that edit a single value. `current` is the value to start
+with, formatted for display; `accepted` receives the new one. */
+using Accepted = std::function<void(std::string)>;
+
+static void showBoolOverlay(const ISchema::BoolEntry* entry, const std::string& current, Accepted accepted);
+static void showIntOverlay(const ISchema::IntEntry* entry, const std::string& current, Accepted accepted);
+static void showDoubleOverlay(const ISchema::DoubleEntry* entry, const std::string& current, Accepted accepted);
+static void showStringOverlay(const ISchema::StringEntry* entry, const std::string& current, Accepted accepted);
+static void showEnumOverlay(const ISchema::EnumEntry* entry, const std::string& current, Accepted accepted);
+
+/* values are read from the preferences once, when the adapter is created,
+and kept (typed, and formatted for display) in a cache. edits only update
+the cache; the keys that changed are written back in one go by Flush(),
+when the overlay is dismissed. */
 class SchemaAdapter: public ScrollAdapterBase {
     public:
         SchemaAdapter(PrefsPtr prefs, SchemaPtr schema): prefs(prefs), schema(schema) {
-            onChanged = [this](std::string value) {
-                this->changed = true;
-            };
+            this->values.resize(schema->Count());
+            for (size_t i = 0; i < this->values.size(); i++) {
+                auto entry = schema->At(i);
+                auto& value = this->values[i];
+                value.type = entry->type;
+                switch (entry->type) {
+                    case ISchema::Type::Bool:
+                        value.boolValue = prefs->GetBool(entry->name, DEFAULT(BoolEntry));
+                        break;
+                    case ISchema::Type::Int:
+                        value.intValue = prefs->GetInt(entry->name, DEFAULT(IntEntry));
+                        break;
+                    case ISchema::Type::Double:
+                        value.doubleValue = prefs->GetDouble(entry->name, DEFAULT(DoubleEntry));
+                        break;
+                    case ISchema::Type::String:
+                        value.stringValue = prefs->GetString(entry->name, DEFAULT(StringEntry));
+                        break;
+                    case ISchema::Type::Enum:
+                        value.stringValue = prefs->GetString(entry->name, DEFAULT(EnumEntry));
+                        break;
+                }
+                this->Format(i);
+            }
         }
 
         virtual ~SchemaAdapter() {
@@ -139,19 +174,23 @@ class SchemaAdapter: public ScrollAdapterBase {
         }
 
         virtual size_t GetEntryCount() override {
-            return schema->Count();
+            return this->values.size();
         }
 
         virtual EntryPtr GetEntry(cursespp::ScrollableWindow* window, size_t index) override {
-            auto entry = schema->At(index);
-
-            std::string name = entry->name;
-            std::string value = stringValueFor(prefs, entry);
+            auto& value = this->values[index];
             int width = window->GetContentWidth();
-            int avail = std::max(0, width - int(u8cols(name)) - 1 - 1);
-            auto display = " " + name + " " + text::Align(value + " ", text::AlignRight, avail);
 
-            SinglePtr result = SinglePtr(new SingleLineEntry(text::Ellipsize(display, width)));
+            /* rows are only laid out again if the width changes */
+            if (value.renderedWidth != width) {
+                std::string name = schema->At(index)->name;
+                int avail = std::max(0, width - int(u8cols(name)) - 1 - 1);
+                auto display = " " + name + " " + text::Align(value.display + " ", text::AlignRight, avail);
+                value.rendered = text::Ellipsize(display, width);
+                value.renderedWidth = width;
+            }
+
+            SinglePtr result = SinglePtr(new SingleLineEntry(value.rendered));
 
             result->SetAttrs(Color(Color::Default));
             if (index == window->GetScrollPosition().logicalIndex) {
@@ -163,44 +202,104 @@ class SchemaAdapter: public ScrollAdapterBase {
 
         void ShowOverlay(size_t index) {
             auto entry = schema->At(index);
+            auto& current = this->values[index].display;
+            auto accepted = [this, index](std::string value) {
+                this->Update(index, value);
+            };
+
             switch (entry->type) {
                 case ISchema::Type::Bool:
-                    return ShowBoolOverlay(reinterpret_cast<const ISchema::BoolEntry*>(entry));
+                    return showBoolOverlay(reinterpret_cast<const ISchema::BoolEntry*>(entry), current, accepted);
                 case ISchema::Type::Int:
-                    return ShowIntOverlay(reinterpret_cast<const ISchema::IntEntry*>(entry));
+                    return showIntOverlay(reinterpret_cast<const ISchema::IntEntry*>(entry), current, accepted);
                 case ISchema::Type::Double:
-                    return ShowDoubleOverlay(reinterpret_cast<const ISchema::DoubleEntry*>(entry));
+                    return showDoubleOverlay(reinterpret_cast<const ISchema::DoubleEntry*>(entry), current, accepted);
                 case ISchema::Type::String:
-                    return ShowStringOverlay(reinterpret_cast<const ISchema::StringEntry*>(entry));
+                    return showStringOverlay(reinterpret_cast<const ISchema::StringEntry*>(entry), current, accepted);
                 case ISchema::Type::Enum:
-                    return ShowEnumOverlay(reinterpret_cast<const ISchema::EnumEntry*>(entry));
+                    return showEnumOverlay(reinterpret_cast<const ISchema::EnumEntry*>(entry), current, accepted);
             }
         }
 
-    private:
-        void ShowBoolOverlay(const ISchema::BoolEntry* entry) {
-            SchemaOverlay::ShowBoolOverlay(entry, prefs, onChanged);
-        }
+        /* writes every value that was edited back to the preferences */
+        void Flush() {
+            bool wrote = false;
 
-        void ShowIntOverlay(const ISchema::IntEntry* entry) {
-            SchemaOverlay::ShowIntOverlay(entry, prefs, onChanged);
-        }
+            for (size_t i = 0; i < this->values.size(); i++) {
+                auto& value = this->values[i];
+                if (!value.dirty) {
+                    continue;
+                }
+
+                std::string name = schema->At(i)->name;
+                switch (value.type) {
+                    case ISchema::Type::Bool: prefs->SetBool(name, value.boolValue); break;
+                    case ISchema::Type::Int: prefs->SetInt(name, value.intValue); break;
+                    case ISchema::Type::Double: prefs->SetDouble(name, value.doubleValue); break;
+                    case ISchema::Type::String:
+                    case ISchema::Type::Enum: prefs->SetString(name, value.stringValue.c_str()); break;
+                }
+
+                value.dirty = false;
+                wrote = true;
+            }
 
-        void ShowDoubleOverlay(const ISchema::DoubleEntry* entry) {
-            SchemaOverlay::ShowDoubleOverlay(entry, prefs, onChanged);
+            if (wrote) {
+                prefs->Save();
+            }
         }
 
-        void ShowStringOverlay(const ISchema::StringEntry* entry) {
-            SchemaOverlay::ShowStringOverlay(entry, prefs, onChanged);
+    private:
+        struct Value {
+            ISchema::Type type;
+            bool boolValue{ false };
+            int intValue{ 0 };
+            double doubleValue{ 0.0 };
+            std::string stringValue;
+            std::string display, rendered;
+            int renderedWidth{ -1 };
+            bool dirty{ false };
+        };
+
+        void Format(size_t index) {
+            auto& value = this->values[index];
+            switch (value.type) {
+                case ISchema::Type::Bool:
+                    value.display = value.boolValue ? "true" : "false";
+                    break;
+                case ISchema::Type::Int:
+                    value.display = std::to_string(value.intValue);
+                    break;
+                case ISchema::Type::Double: {
+                    auto entry = reinterpret_cast<const ISchema::DoubleEntry*>(schema->At(index));
+                    value.display = stringValueForDouble(value.doubleValue, entry->precision);
+                    break;
+                }
+                case ISchema::Type::String:
+                case ISchema::Type::Enum:
+                    value.display = value.stringValue;
+                    break;
+            }
+            value.renderedWidth = -1;
         }
 
-        void ShowEnumOverlay(const ISchema::EnumEntry* entry) {
-            SchemaOverlay::ShowEnumOverlay(entry, prefs, onChanged);
+        void Update(size_t index, const std::string& text) {
+            auto& value = this->values[index];
+            switch (value.type) {
+                case ISchema::Type::Bool: value.boolValue = (text == "true"); break;
+                case ISchema::Type::Int: value.intValue = (int) std::stod(text); break;
+                case ISchema::Type::Double: value.doubleValue = std::stod(text); break;
+                case ISchema::Type::String:
+                case ISchema::Type::Enum: value.stringValue = text; break;
+            }
+            value.dirty = true;
+            this->changed = true;
+            this->Format(index);
         }
 
-        std::function<void(std::string)> onChanged;
         PrefsPtr prefs;
         SchemaPtr schema;
+        std::vector<Value> values;
         bool changed{false};
 };
 
@@ -236,20 +335,83 @@ void SchemaOverlay::ShowListOverlay(
     cursespp::App::Overlays().Push(dialog);
 }
 
+static void showBoolOverlay(const ISchema::BoolEntry* entry, const std::string& current, Accepted accepted) {
+    std::vector<std::string> items = { "true", "false" };
+    SchemaOverlay::ShowListOverlay(entry->entry.name, items, current, accepted);
+}
+
+static void showIntOverlay(const ISchema::IntEntry* entry, const std::string& current, Accepted accepted) {
+    auto title = numberInputTitle(
+        std::string(entry->entry.name), entry->minValue, entry->maxValue, INT_FORMATTER);
+
+    auto validator = std::make_shared<NumberValidator<int>>(
+        entry->minValue,  entry->maxValue, INT_FORMATTER);
+
+    std::shared_ptr<InputOverlay> dialog(new InputOverlay());
+
+    dialog->SetTitle(title)
+        .SetText(current)
+        .SetValidator(validator)
+        .SetWidth(overlayWidth())
+        .SetInputAcceptedCallback(accepted);
+
+    App::Overlays().Push(dialog);
+}
+
+static void showDoubleOverlay(const ISchema::DoubleEntry* entry, const std::string& current, Accepted accepted) {
+    auto formatter = doubleFormatter(entry->precision);
+
+    auto title = numberInputTitle(
+        std::string(entry->entry.name), entry->minValue, entry->maxValue, formatter);
+
+    auto validator = std::make_shared<NumberValidator<double>>(
+        entry->minValue, entry->maxValue, formatter);
+
+    std::shared_ptr<InputOverlay> dialog(new InputOverlay());
+
+    dialog->SetTitle(title)
+        .SetText(current)
+        .SetValidator(validator)
+        .SetWidth(overlayWidth())
+        .SetInputAcceptedCallback(accepted);
+
+    App::Overlays().Push(dialog);
+}
+
+static void showStringOverlay(const ISchema::StringEntry* entry, const std::string& current, Accepted accepted) {
+    std::shared_ptr<InputOverlay> dialog(new InputOverlay());
+
+    dialog->SetTitle(entry->entry.name)
+        .SetText(current)
+        .SetWidth(overlayWidth())
+        .SetInputAcceptedCallback(accepted);
+
+    App::Overlays().Push(dialog);
+}
+
+static void showEnumOverlay(const ISchema::EnumEntry* entry, const std::string& current, Accepted accepted) {
+    std::vector<std::string> items;
+
+    for (size_t i = 0; i < entry->count; i++) {
+        items.push_back(entry->values[i]);
+    }
+
+    SchemaOverlay::ShowListOverlay(entry->entry.name, items, current, accepted);
+}
+
 void SchemaOverlay::ShowBoolOverlay(
     const ISchema::BoolEntry* entry,
     PrefsPtr prefs,
     std::function<void(std::string)> callback)
 {
     std::string name(entry->entry.name);
-    std::vector<std::string> items = { "true", "false" };
 
     auto handler = [prefs, name, callback](std::string value) {
         prefs->SetBool(name, value == "true");
         if (callback) { callback(value); }
     };
 
-    ShowListOverlay(name, items, stringValueFor(prefs, entry), handler);
+    showBoolOverlay(entry, stringValueFor(prefs, entry), handler);
 }
 
 void SchemaOverlay::ShowIntOverlay(
@@ -259,26 +421,12 @@ void SchemaOverlay::ShowIntOverlay(
 {
     std::string name(entry->entry.name);
 
-    auto title = numberInputTitle(
-        name, entry->minValue, entry->maxValue, INT_FORMATTER);
-
-    auto validator = std::make_shared<NumberValidator<int>>(
-        entry->minValue,  entry->maxValue, INT_FORMATTER);
-
     auto handler = [prefs, name, callback](std::string value) {
         prefs->SetInt(name, (int) std::stod(value));
         if (callback) { callback(value); }
     };
 
-    std::shared_ptr<InputOverlay> dialog(new InputOverlay());
-
-    dialog->SetTitle(title)
-        .SetText(stringValueFor(prefs, entry))
-        .SetValidator(validator)
-        .SetWidth(overlayWidth())
-        .SetInputAcceptedCallback(callback);
-
-    App::Overlays().Push(dialog);
+    showIntOverlay(entry, stringValueFor(prefs, entry), handler);
 }
 
 void SchemaOverlay::ShowDoubleOverlay(
@@ -288,28 +436,12 @@ void SchemaOverlay::ShowDoubleOverlay(
 {
     std::string name(entry->entry.name);
 
-    auto formatter = doubleFormatter(entry->precision);
-
-    auto title = numberInputTitle(
-        name, entry->minValue, entry->maxValue, formatter);
-
-    auto validator = std::make_shared<NumberValidator<double>>(
-        entry->minValue, entry->maxValue, formatter);
-
     auto handler = [prefs, name, callback](std::string value) {
         prefs->SetDouble(name, std::stod(value));
         if (callback) { callback(value); }
     };
 
-    std::shared_ptr<InputOverlay> dialog(new InputOverlay());
-
-    dialog->SetTitle(title)
-        .SetText(stringValueFor(prefs, entry))
-        .SetValidator(validator)
-        .SetWidth(overlayWidth())
-        .SetInputAcceptedCallback(handler);
-
-    App::Overlays().Push(dialog);
+    showDoubleOverlay(entry, stringValueFor(prefs, entry), handler);
 }
 
 void SchemaOverlay::ShowStringOverlay(
@@ -324,14 +456,7 @@ void SchemaOverlay::ShowStringOverlay(
         if (callback) { callback(value); }
     };
 
-    std::shared_ptr<InputOverlay> dialog(new InputOverlay());
-
-    dialog->SetTitle(name)
-        .SetText(stringValueFor(prefs, entry))
-        .SetWidth(overlayWidth())
-        .SetInputAcceptedCallback(handler);
-
-    App::Overlays().Push(dialog);
+    showStringOverlay(entry, stringValueFor(prefs, entry), handler);
 }
 
 void SchemaOverlay::ShowEnumOverlay(
@@ -340,18 +465,13 @@ void SchemaOverlay::ShowEnumOverlay(
     std::function<void(std::string)> callback)
 {
     std::string name(entry->entry.name);
-    std::vector<std::string> items;
-
-    for (size_t i = 0; i < entry->count; i++) {
-        items.push_back(entry->values[i]);
-    }
 
     auto handler = [prefs, name, callback](std::string value) {
         prefs->SetString(name, value.c_str());
         if (callback) { callback(value); }
     };
 
-    ShowListOverlay(name, items, stringValueFor(prefs, entry), handler);
+    showEnumOverlay(entry, stringValueFor(prefs, entry), handler);
 }
 
 void SchemaOverlay::Show(
@@ -372,6 +492,7 @@ void SchemaOverlay::Show(
                 schemaAdapter->ShowOverlay(index);
             })
         .SetDismissedCallback([callback, schemaAdapter](ListOverlay* overlay) {
+                schemaAdapter->Flush();
                 if (callback) {
                     callback(schemaAdapter->Changed());
                 }
@@ -34,14 +34,79 @@
 
 #include <cursespp/ScrollAdapterBase.h>
 #include <cursespp/ScrollableWindow.h>
+#include <cursespp/Draw.h>
 #include <cursespp/MultiLineEntry.h>
 #include <cursespp/ListWindow.h>
+#include <cursespp/Text.h>
 #include <f8n/str/utf.h>
 
 using namespace cursespp;
 using namespace f8n::utf;
 
 typedef IScrollAdapter::EntryPtr EntryPtr;
+typedef IScrollAdapter::Spans Spans;
+typedef IScrollAdapter::IStyledEntry IStyledEntry;
+
+/* draws a line in runs of identical attributes, so attributes are only
+switched where a run actually changes. if the line was decorated (e.g. it's
+selected) the decorator's color wins, but the rest of each span's attributes
+(bold, underline, ...) still apply. */
+static void drawSpans(
+    WINDOW* window,
+    const std::string& line,
+    size_t width,
+    const IScrollAdapter::Spans& spans,
+    int64_t base,
+    bool decorated)
+{
+    int64_t lineAttrs = (base == -1) ? A_NORMAL : base;
+    auto begin = line.begin(), end = line.end();
+    auto run = begin, it = begin;
+    int64_t current = lineAttrs;
+    size_t column = 0, s = 0;
+
+    wattrset(window, lineAttrs);
+
+    while (it != end) {
+        while (s < spans.size() && column >= spans[s].column + spans[s].length) {
+            ++s;
+        }
+
+        int64_t desired = lineAttrs;
+        if (s < spans.size() && column >= spans[s].column) {
+            desired = decorated
+                ? ((spans[s].attrs & ~A_COLOR) | lineAttrs)
+                : spans[s].attrs;
+        }
+
+        if (desired != current) {
+            draw::Text(window, line.data() + (run - begin), it - run);
+            wattrset(window, desired);
+            current = desired;
+            run = it;
+        }
+
+        auto prev = it;
+
+        try {
+            column += text::Columns(utf8::next(it, end));
+        }
+        catch (...) {
+            /* invalid encoding, just treat as a single char */
+            it = prev + 1;
+            column += 1;
+        }
+    }
+
+    draw::Text(window, line.data() + (run - begin), it - run);
+
+    if (column < width) {
+        wattrset(window, lineAttrs);
+        draw::Fill(window, width - column);
+    }
+
+    wattrset(window, A_NORMAL);
+}
 
 ScrollAdapterBase::ScrollAdapterBase() {
     this->height = 0;
@@ -126,44 +191,48 @@ void ScrollAdapterBase::DrawPage(ScrollableWindow* scrollable, size_t index, Scr
     size_t topIndex = GetVisibleItems(scrollable, index, visible);
 
     size_t drawnLines = 0;
+    Spans spans;
 
     for (size_t e = 0; e < visible.size(); e++) {
         EntryPtr entry = visible.at(e);
+        auto styled = dynamic_cast<IStyledEntry*>(entry.get());
         size_t count = entry->GetLineCount();
 
         for (size_t i = 0; i < count && drawnLines < this->height; i++) {
             Color attrs = Color::Default;
+            bool decorated = false;
 
             if (this->decorator) {
                 attrs = this->decorator(scrollable, topIndex + e, i, entry);
+                decorated = (attrs != -1);
             }
 
             if (attrs == -1) {
                 attrs = entry->GetAttrs(i);
             }
 
-            if (attrs != -1) {
-                wattron(window, attrs);
-            }
-
             std::string line = entry->GetLine(i);
-            size_t len = u8cols(line);
 
-            /* pad with empty spaces to the end of the line. this allows us to
-            do highlight rows. this should probably be configurable. */
+            wmove(window, (int) drawnLines, 0);
 
-            int remain = this->width - len;
-            if (remain > 0) {
-                line += std::string(remain, ' ');
+            spans.clear();
+            if (styled) {
+                styled->GetSpans(i, spans);
             }
 
-            /* string is padded above, we don't need a \n */
-
-            checked_wprintw(window, "%s", line.c_str());
-
-            if (attrs != -1) {
+            if (!spans.empty()) {
+                drawSpans(window, line, this->width, spans, attrs, decorated);
+            }
+            else if (attrs != -1) {
+                /* fill to the end of the line in the line's attributes. this
+                allows us to do highlight rows. */
+                wattron(window, attrs);
+                draw::Line(window, line, u8cols(line), this->width);
                 wattroff(window, attrs);
             }
+            else {
+                draw::Text(window, line);
+            }
 
             ++drawnLines;
         }
@@ -113,7 +113,7 @@ void ScrollableWindow::SetAllowArrowKeyPropagation(bool allow) {
     this->allowArrowKeyPropagation = allow;
 }
 
-bool ScrollableWindow::KeyPress(const std::string& key) {
+bool ScrollableWindow::KeyPress(KeyId key) {
     /* note we allow KEY_DOWN and KEY_UP to continue to propagate if
     the logical (selected) index doesn't actually change -- i.e. the
     user is at the beginning or end of the scrollable area. this is so
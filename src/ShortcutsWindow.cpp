@@ -34,6 +34,7 @@
 
 #include <cursespp/ShortcutsWindow.h>
 #include <cursespp/Colors.h>
+#include <cursespp/Draw.h>
 #include <cursespp/Text.h>
 #include <f8n/str/utf.h>
 
@@ -106,8 +107,40 @@ void ShortcutsWindow::SetChangedCallback(ChangedCallback callback) {
     this->changedCallback = callback;
 }
 
-bool ShortcutsWindow::KeyPress(const std::string& key) {
-    if (this->changedCallback && this->IsFocused()) {
+void ShortcutsWindow::SetKeymap(std::shared_ptr<Keymap> keymap) {
+    this->keymap = keymap;
+    this->SyncKeymap();
+    this->Redraw();
+}
+
+void ShortcutsWindow::SyncKeymap() {
+    if (!this->keymap) {
+        return;
+    }
+
+    this->entries.clear();
+
+    for (auto& binding : this->keymap->Bindings()) {
+        if (binding.caption.size()) {
+            this->entries.push_back(std::shared_ptr<Entry>(
+                new Entry(binding.sequence, binding.caption)));
+        }
+    }
+
+    this->keymapGeneration = this->keymap->Generation();
+}
+
+void ShortcutsWindow::Activate(const std::string& key) {
+    if (this->changedCallback) {
+        this->changedCallback(key);
+    }
+    else if (this->keymap) {
+        this->keymap->Invoke(key);
+    }
+}
+
+bool ShortcutsWindow::KeyPress(KeyId key) {
+    if ((this->changedCallback || this->keymap) && this->IsFocused()) {
         int count = (int) this->entries.size();
         if (count > 0) {
             auto& keys = NavigationKeys();
@@ -134,14 +167,11 @@ bool ShortcutsWindow::KeyPress(const std::string& key) {
                 this->Redraw();
                 return true;
             }
-            else if (key == "KEY_ENTER") {
+            else if (key == key::Enter) {
                 /* replace the original key we cached when we were forcused originally
                 to "commit" the operation, as it'll be swapped back when we lose focus */
                 this->originalKey = this->activeKey;
-
-                if (this->changedCallback) {
-                    this->changedCallback(this->activeKey);
-                }
+                this->Activate(this->activeKey);
             }
         }
     }
@@ -158,11 +188,7 @@ bool ShortcutsWindow::MouseEvent(const IMouseHandler::Event& mouseEvent) {
                 this->activeKey = entry->key;
 
                 this->Redraw();
-
-                if (this->changedCallback) {
-                    this->changedCallback(this->activeKey);
-                }
-
+                this->Activate(this->activeKey);
                 return true;
             }
         }
@@ -193,6 +219,10 @@ int ShortcutsWindow::getActiveIndex() {
 }
 
 void ShortcutsWindow::OnRedraw() {
+    if (this->keymap && this->keymap->Generation() != this->keymapGeneration) {
+        this->SyncKeymap();
+    }
+
     this->Clear();
 
     Color normalAttrs = Color(Color::ButtonDefault);
@@ -211,7 +241,7 @@ void ShortcutsWindow::OnRedraw() {
         int64_t keyAttrs = (e->attrs == -1) ? normalAttrs : e->attrs;
         keyAttrs = (e->key == this->activeKey) ? activeAttrs : keyAttrs;
 
-        checked_wprintw(c, " ");
+        draw::Fill(c, 1);
         --remaining;
 
         if (remaining == 0) {
@@ -236,7 +266,7 @@ void ShortcutsWindow::OnRedraw() {
         }
 
         wattron(c, keyAttrs);
-        checked_wprintw(c, key.c_str());
+        draw::Text(c, key);
         wattroff(c, keyAttrs);
 
         remaining -= len;
@@ -252,7 +282,7 @@ void ShortcutsWindow::OnRedraw() {
             len = remaining;
         }
 
-        checked_wprintw(c, value.c_str());
+        draw::Text(c, value);
         remaining -= len;
     }
 }
@@ -37,9 +37,12 @@
 #include <cursespp/MultiLineEntry.h>
 #include <cursespp/ScrollableWindow.h>
 #include <cursespp/Colors.h>
+#include <f8n/str/utf.h>
 #include <utf8/utf8/unchecked.h>
+#include <algorithm>
 
 using namespace cursespp;
+using namespace f8n::utf;
 
 #define MAX_ENTRY_COUNT 0xffffffff
 
@@ -47,6 +50,8 @@ typedef IScrollAdapter::EntryPtr EntryPtr;
 
 SimpleScrollAdapter::SimpleScrollAdapter() {
     this->maxEntries = MAX_ENTRY_COUNT;
+    this->maxEntryWidth = 0;
+    this->unmeasured = 0;
     this->selectable = false;
 }
 
@@ -60,9 +65,16 @@ void SimpleScrollAdapter::SetSelectable(bool selectable) {
 
 void SimpleScrollAdapter::Clear() {
     this->entries.clear();
+    this->maxEntryWidth = 0;
+    this->unmeasured = 0;
     this->Changed(this);
 }
 
+size_t SimpleScrollAdapter::GetMaxEntryWidth() {
+    /* only single line entries are measured as they're added */
+    return this->unmeasured ? IMeasuredAdapter::Unknown : this->maxEntryWidth;
+}
+
 size_t SimpleScrollAdapter::GetEntryCount() {
     return this->entries.size();
 }
@@ -107,7 +119,18 @@ void SimpleScrollAdapter::AddEntry(std::shared_ptr<IEntry> entry) {
     entry->SetWidth(this->GetWidth());
     entries.push_back(entry);
 
+    auto single = dynamic_cast<SingleLineEntry*>(entry.get());
+    if (single) {
+        this->maxEntryWidth = std::max(this->maxEntryWidth, u8cols(single->GetValue()));
+    }
+    else {
+        ++this->unmeasured;
+    }
+
     while (entries.size() > this->maxEntries) {
+        if (!dynamic_cast<SingleLineEntry*>(entries.front().get())) {
+            --this->unmeasured;
+        }
         entries.pop_front();
     }
 
@@ -62,4 +62,18 @@ size_t SingleLineEntry::GetLineCount() {
 
 std::string SingleLineEntry::GetLine(size_t line) {
     return text::Ellipsize(this->value, this->width);
-}
\ No newline at end of file
+}
+
+void SingleLineEntry::GetSpans(size_t line, IScrollAdapter::Spans& target) {
+    target.insert(target.end(), this->spans.begin(), this->spans.end());
+}
+
+void SingleLineEntry::AddSpan(size_t column, size_t length, int64_t attrs) {
+    if (length > 0) {
+        this->spans.push_back({ column, length, attrs });
+    }
+}
+
+void SingleLineEntry::ClearSpans() {
+    this->spans.clear();
+}
@@ -39,6 +39,7 @@
 
 #include <unordered_map>
 #include <algorithm>
+#include <wchar.h>
 
 using namespace f8n::utf;
 
@@ -75,6 +76,39 @@ namespace cursespp {
             return str;
         }
 
+#ifdef WIN32
+        /* wchar_t is 16 bits here and there's no wcwidth(), so cover the
+        common zero width and double width ranges by hand. */
+        static size_t wcwidth(uint32_t c) {
+            if ((c >= 0x0300 && c <= 0x036f) || (c >= 0x200b && c <= 0x200f) ||
+                (c >= 0x20d0 && c <= 0x20ff) || (c >= 0xfe00 && c <= 0xfe0f))
+            {
+                return 0;
+            }
+
+            if ((c >= 0x1100 && c <= 0x115f) ||
+                (c >= 0x2e80 && c <= 0xa4cf && c != 0x303f) ||
+                (c >= 0xac00 && c <= 0xd7a3) || (c >= 0xf900 && c <= 0xfaff) ||
+                (c >= 0xfe30 && c <= 0xfe4f) || (c >= 0xff00 && c <= 0xff60) ||
+                (c >= 0xffe0 && c <= 0xffe6) || (c >= 0x1f300 && c <= 0x1f64f) ||
+                (c >= 0x1f900 && c <= 0x1f9ff) || (c >= 0x20000 && c <= 0x3fffd))
+            {
+                return 2;
+            }
+
+            return 1;
+        }
+#endif
+
+        size_t Columns(uint32_t codepoint) {
+#ifdef WIN32
+            return wcwidth(codepoint);
+#else
+            int result = ::wcwidth((wchar_t) codepoint);
+            return (result < 0) ? 1 : (size_t) result; /* control chars etc */
+#endif
+        }
+
         std::string Ellipsize(const std::string& str, size_t len) {
             if (u8cols(str) > len) {
                 std::string trunc = Truncate(str, len - 2);
@@ -265,6 +299,88 @@ namespace cursespp {
             }
         }
 
+        static inline bool isBreakable(const std::string& line, size_t offset, size_t bytes) {
+            if (bytes != 1) {
+                return false;
+            }
+            char c = line[offset];
+            return c == ' ' || c == '\t' || c == '\v' || c == '\f' || c == '\r';
+        }
+
+        void WrapLine(const std::string& line, size_t width, std::vector<WrappedRow>& rows) {
+            static const size_t NONE = (size_t) -1;
+
+            rows.clear();
+
+            WrappedRow row = { 0, 0, 0, 0 };
+            size_t rowColumns = 0, column = 0, index = 0;
+            size_t breakOffset = NONE, breakIndex = 0, breakColumn = 0;
+
+            auto begin = line.begin();
+            auto it = line.begin();
+            auto end = line.end();
+
+            while (it != end) {
+                auto prev = it;
+                size_t cols = 1;
+
+                try {
+                    cols = Columns(utf8::next(it, end));
+                }
+                catch (...) {
+                    /* invalid encoding, just treat as a single char */
+                    it = prev + 1;
+                }
+
+                size_t offset = prev - begin;
+                size_t bytes = it - prev;
+                bool breakable = isBreakable(line, offset, bytes);
+
+                if (width > 0 && rowColumns > 0 && rowColumns + cols > width) {
+                    if (breakable) {
+                        /* the whitespace at the end of the row is swallowed */
+                        row.bytes = offset - row.offset;
+                        rows.push_back(row);
+                        row = { offset + bytes, 0, index + 1, column + cols };
+                        rowColumns = 0;
+                        breakOffset = NONE;
+                        column += cols;
+                        ++index;
+                        continue;
+                    }
+                    else if (breakOffset != NONE) {
+                        /* wrap at the last whitespace */
+                        row.bytes = breakOffset - row.offset;
+                        rows.push_back(row);
+                        row = { breakOffset, 0, breakIndex, breakColumn };
+                        rowColumns = column - breakColumn;
+                    }
+                    else {
+                        /* one long word: break it where it is */
+                        row.bytes = offset - row.offset;
+                        rows.push_back(row);
+                        row = { offset, 0, index, column };
+                        rowColumns = 0;
+                    }
+
+                    breakOffset = NONE;
+                }
+
+                rowColumns += cols;
+                column += cols;
+                ++index;
+
+                if (breakable) {
+                    breakOffset = offset + bytes;
+                    breakIndex = index;
+                    breakColumn = column;
+                }
+            }
+
+            row.bytes = line.size() - row.offset;
+            rows.push_back(row);
+        }
+
         std::vector<std::string> BreakLines(const std::string& line, size_t width) {
             std::vector<std::string> result;
 
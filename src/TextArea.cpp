@@ -0,0 +1,642 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+#include <cursespp/TextArea.h>
+#include <cursespp/ScrollAdapterBase.h>
+#include <cursespp/Screen.h>
+#include <f8n/runtime/Message.h>
+#include <f8n/str/utf.h>
+
+using namespace cursespp;
+using namespace f8n::runtime;
+using namespace f8n::utf;
+
+#define MESSAGE_DRAW_PAGE 1
+
+
+typedef IScrollAdapter::EntryPtr EntryPtr;
+
+/* keeps control characters out of the document; tabs become spaces so
+every character has a well defined width */
+static std::string sanitize(const std::string& text) {
+    std::string result;
+    result.reserve(text.size());
+    for (char c : text) {
+        if (c == '\t') {
+            result += ' ';
+        }
+        else if (c == '\n' || ((unsigned char) c >= 0x20 && c != 0x7f)) {
+            result += c;
+        }
+    }
+    return result;
+}
+
+class LineEntry : public IScrollAdapter::IEntry {
+    public:
+        LineEntry(const std::string& value) : value(value), width(0) { }
+
+        virtual size_t GetLineCount() { return std::max((size_t) 1, this->rows.size()); }
+        virtual Color GetAttrs(size_t line) { return Color::Default; }
+
+        virtual std::string GetLine(size_t line) {
+            if (line < this->rows.size()) {
+                auto& row = this->rows[line];
+                return this->value.substr(row.offset, row.bytes);
+            }
+            return "";
+        }
+
+        virtual void SetWidth(size_t width) {
+            if (this->width != width && width > 0) {
+                this->width = width;
+                text::WrapLine(this->value, width, this->rows);
+            }
+        }
+
+    private:
+        std::string value;
+        std::vector<text::WrappedRow> rows;
+        size_t width;
+};
+
+class TextArea::Adapter : public ScrollAdapterBase {
+    public:
+        Adapter(TextArea* owner) : owner(owner) { }
+
+        virtual size_t GetEntryCount() {
+            return this->owner->GetLineCount();
+        }
+
+        virtual EntryPtr GetEntry(ScrollableWindow* window, size_t index) {
+            return std::make_shared<LineEntry>(this->owner->GetLine(index));
+        }
+
+    private:
+        TextArea* owner;
+};
+
+TextArea::TextArea(IWindow *parent)
+: ScrollableWindow(parent)
+, preferredColumn(0)
+, cursorRow(0)
+, cursorColumn(0)
+, cursorLineWidth(0)
+, pendingTop(0) {
+    this->documentAdapter = std::make_shared<Adapter>(this);
+    this->SetAdapter(this->documentAdapter);
+}
+
+TextArea::~TextArea() {
+}
+
+const std::string& TextArea::GetLine(size_t index) {
+    if (index < this->above.size()) {
+        return this->above[index];
+    }
+    else if (index == this->above.size()) {
+        return this->current.Text();
+    }
+
+    index -= this->above.size() + 1;
+    return this->below[this->below.size() - 1 - index];
+}
+
+void TextArea::SetText(const std::string& text) {
+    this->above.clear();
+    this->below.clear();
+    this->current.Clear();
+
+    std::string sanitized = sanitize(text);
+
+    /* the cursor goes to the top; lines are pushed onto `below` backwards */
+    size_t end = sanitized.size();
+    size_t newline = sanitized.rfind('\n');
+    while (newline != std::string::npos) {
+        this->below.push_back(sanitized.substr(newline + 1, end - newline - 1));
+        end = newline;
+        newline = (newline == 0) ? std::string::npos : sanitized.rfind('\n', newline - 1);
+    }
+
+    this->current.Assign(sanitized.substr(0, end));
+    this->current.MoveTo(0);
+    this->preferredColumn = 0;
+
+    this->history.Clear();
+    this->GetMutableScrollPosition().firstVisibleEntryIndex = 0;
+    this->Changed();
+}
+
+std::string TextArea::GetText() {
+    std::string result;
+    size_t count = this->GetLineCount();
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0) {
+            result += "\n";
+        }
+        result += this->GetLine(i);
+    }
+    return result;
+}
+
+size_t TextArea::Length() {
+    return this->current.Length();
+}
+
+size_t TextArea::Position() {
+    return this->cursorColumn;
+}
+
+size_t TextArea::Row() {
+    return this->cursorRow;
+}
+
+void TextArea::MoveToLine(size_t line) {
+    line = std::min(line, this->GetLineCount() - 1);
+    size_t cursor = this->above.size();
+
+    if (line == cursor) {
+        return;
+    }
+
+    this->cursorLineWidth = 0;
+
+    /* park the current line, shuffle whole strings across the gap, then
+    load the destination line */
+    if (line < cursor) {
+        this->below.push_back(this->current.Text());
+        while (this->above.size() > line + 1) {
+            this->below.push_back(std::move(this->above.back()));
+            this->above.pop_back();
+        }
+        this->current.Assign(this->above.back());
+        this->above.pop_back();
+    }
+    else {
+        this->above.push_back(this->current.Text());
+        while (this->above.size() < line) {
+            this->above.push_back(std::move(this->below.back()));
+            this->below.pop_back();
+        }
+        this->current.Assign(this->below.back());
+        this->below.pop_back();
+    }
+}
+
+void TextArea::SetCursor(size_t line, size_t column) {
+    this->MoveToLine(line);
+    this->current.MoveTo(column);
+    this->preferredColumn = this->current.Position();
+    this->history.Break();
+    this->ScrollToCursor();
+}
+
+void TextArea::BreakLine() {
+    size_t position = this->current.Position();
+    std::string tail = this->current.Slice(position, TextBuffer::npos);
+    while (this->current.EraseAfter()) { }
+    this->above.push_back(this->current.Text());
+    this->current.Assign(tail);
+    this->current.MoveTo(0);
+}
+
+void TextArea::EraseForward(size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (!this->current.EraseAfter() && this->below.size()) {
+            size_t position = this->current.Position();
+            this->current.Insert(this->below.back());
+            this->below.pop_back();
+            this->current.MoveTo(position);
+        }
+    }
+}
+
+void TextArea::Insert(const std::string& text) {
+    size_t newline = text.find('\n');
+
+    if (newline == std::string::npos) {
+        this->current.Insert(text);
+    }
+    else {
+        /* detach everything after the cursor once, rather than carrying it
+        along through every inserted line */
+        size_t position = this->current.Position();
+        std::string tail = this->current.Slice(position, TextBuffer::npos);
+        while (this->current.EraseAfter()) { }
+
+        size_t start = 0;
+        while (newline != std::string::npos) {
+            this->current.Insert(text.substr(start, newline - start));
+            this->above.push_back(this->current.Text());
+            this->current.Clear();
+            start = newline + 1;
+            newline = text.find('\n', start);
+        }
+
+        this->current.Insert(text.substr(start));
+        position = this->current.Position();
+        this->current.Insert(tail);
+        this->current.MoveTo(position);
+    }
+
+    this->preferredColumn = this->current.Position();
+}
+
+bool TextArea::Write(const std::string& key) {
+    if (u8len(key) == 1) {
+        std::string sanitized = sanitize(key);
+        if (sanitized.size() && sanitized != "\n") {
+            this->history.Insert(this->above.size(), this->current.Position(), sanitized);
+            this->Insert(sanitized);
+            this->Changed();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TextArea::Paste(const std::string& text) {
+    std::string sanitized = sanitize(text);
+    if (sanitized.size()) {
+        /* a paste is always its own undo step */
+        this->history.Break();
+        this->history.Insert(this->above.size(), this->current.Position(), sanitized);
+        this->history.Break();
+        this->Insert(sanitized);
+        this->Changed();
+    }
+    return true;
+}
+
+bool TextArea::KeyPress(KeyId key) {
+    auto& keys = NavigationKeys();
+
+    size_t line = this->above.size();
+    size_t position = this->current.Position();
+
+    if (keys.Undo(key)) {
+        this->Undo();
+        return true;
+    }
+    else if (keys.Redo(key)) {
+        this->Redo();
+        return true;
+    }
+    else if (key == key::Enter) {
+        this->history.Insert(line, position, "\n");
+        this->BreakLine();
+        this->preferredColumn = 0;
+        this->Changed();
+        return true;
+    }
+    else if (key == key::Backspace) {
+        if (position > 0) {
+            this->history.Erase(line, position - 1, this->current.Range(position - 1, 1));
+            this->current.EraseBefore();
+            this->preferredColumn = this->current.Position();
+            this->Changed();
+        }
+        else if (this->above.size()) {
+            /* join with the previous line */
+            this->history.Erase(line - 1, u8len(this->above.back()), "\n");
+            std::string rest = this->current.Text();
+            this->current.Assign(this->above.back());
+            this->above.pop_back();
+            size_t joined = this->current.Position();
+            this->current.Insert(rest);
+            this->current.MoveTo(joined);
+            this->preferredColumn = joined;
+            this->Changed();
+        }
+        return true;
+    }
+    else if (key == key::Delete) {
+        if (position < this->current.Length()) {
+            this->history.Erase(line, position, this->current.Range(position, 1));
+            this->current.EraseAfter();
+            this->Changed();
+        }
+        else if (this->below.size()) {
+            /* join with the next line */
+            this->history.Erase(line, position, "\n");
+            this->current.Insert(this->below.back());
+            this->below.pop_back();
+            this->current.MoveTo(position);
+            this->Changed();
+        }
+        return true;
+    }
+    else if (key == key::Left) {
+        if (this->current.Position() > 0) {
+            this->SetCursor(line, this->current.Position() - 1);
+        }
+        else if (line > 0) {
+            this->MoveToLine(line - 1);
+            this->SetCursor(line - 1, this->current.Length());
+        }
+        return true;
+    }
+    else if (key == key::Right) {
+        if (this->current.Position() < this->current.Length()) {
+            this->SetCursor(line, this->current.Position() + 1);
+        }
+        else if (this->below.size()) {
+            this->SetCursor(line + 1, 0);
+        }
+        return true;
+    }
+    else if (key == key::Up || key == key::Down) {
+        size_t column = this->preferredColumn;
+        if (key == key::Up && line > 0) {
+            this->MoveToLine(line - 1);
+        }
+        else if (key == key::Down && this->below.size()) {
+            this->MoveToLine(line + 1);
+        }
+        this->current.MoveTo(column);
+        this->history.Break();
+        this->ScrollToCursor();
+        return true;
+    }
+    else if (key == key::Home) {
+        this->SetCursor(line, 0);
+        return true;
+    }
+    else if (key == key::End) {
+        this->SetCursor(line, this->current.Length());
+        return true;
+    }
+    else if (key == key::PageUp) {
+        this->PageUp();
+        return true;
+    }
+    else if (key == key::PageDown) {
+        this->PageDown();
+        return true;
+    }
+
+    return false;
+}
+
+void TextArea::PageUp() {
+    size_t page = (size_t) std::max(1, this->GetContentHeight() - 1);
+    size_t line = this->above.size();
+    size_t column = this->preferredColumn;
+    this->MoveToLine(line > page ? line - page : 0);
+    this->current.MoveTo(column);
+    this->history.Break();
+    this->ScrollToCursor();
+}
+
+void TextArea::PageDown() {
+    size_t page = (size_t) std::max(1, this->GetContentHeight() - 1);
+    size_t column = this->preferredColumn;
+    this->MoveToLine(this->above.size() + page);
+    this->current.MoveTo(column);
+    this->history.Break();
+    this->ScrollToCursor();
+}
+
+bool TextArea::MouseEvent(const IMouseHandler::Event& event) {
+    if (event.Button1Clicked()) {
+        /* walk the visible rows to find the clicked line and row */
+        size_t width = (size_t) std::max(1, this->GetContentWidth());
+        size_t line = this->GetScrollPosition().firstVisibleEntryIndex;
+        size_t count = this->GetLineCount();
+        int y = std::max(0, event.y);
+
+        while (line < count) {
+            text::WrapLine(this->GetLine(line), width, this->rows);
+            if (y < (int) this->rows.size() || line == count - 1) {
+                break;
+            }
+            y -= (int) this->rows.size();
+            ++line;
+        }
+
+        line = std::min(line, count - 1);
+        const std::string& value = this->GetLine(line);
+        auto& row = this->rows[std::min((size_t) y, this->rows.size() - 1)];
+
+        /* then the code point under the column */
+        size_t index = row.index;
+        size_t column = 0;
+        auto it = value.begin() + row.offset;
+        auto end = it + row.bytes;
+        while (it != end) {
+            auto prev = it;
+            size_t cols = 1;
+            try {
+                cols = text::Columns(utf8::next(it, end));
+            }
+            catch (...) {
+                it = prev + 1;
+            }
+            column += cols;
+            if ((int) column > event.x) {
+                break;
+            }
+            ++index;
+        }
+
+        this->SetCursor(line, index);
+        this->FocusInParent();
+        return true;
+    }
+
+    return ScrollableWindow::MouseEvent(event);
+}
+
+void TextArea::OnRedraw() {
+    this->DrawPage(this->GetScrollPosition().firstVisibleEntryIndex);
+}
+
+void TextArea::OnDimensionsChanged() {
+    ScrollableWindow::OnDimensionsChanged();
+    this->ScrollToCursor();
+}
+
+void TextArea::OnAdapterChanged() {
+    this->GetScrollAdapter().SetDisplaySize(
+        this->GetContentWidth(),
+        this->GetContentHeight());
+
+    this->ScrollToCursor();
+}
+
+void TextArea::Changed() {
+    this->cursorLineWidth = 0; /* the cursor's line was edited */
+    this->ScrollToCursor();
+    this->TextChanged(this);
+}
+
+size_t TextArea::RowCount(size_t line) {
+    if (line == this->above.size()) {
+        return this->CursorLineRows().size();
+    }
+
+    size_t width = (size_t) std::max(1, this->GetContentWidth());
+    text::WrapLine(this->GetLine(line), width, this->rows);
+    return this->rows.size();
+}
+
+const std::vector<text::WrappedRow>& TextArea::CursorLineRows() {
+    /* moving the cursor within its line doesn't change how the line wraps,
+    so the rows are kept until the line is edited, left, or resized */
+    size_t width = (size_t) std::max(1, this->GetContentWidth());
+    if (this->cursorLineWidth != width) {
+        text::WrapLine(this->current.Text(), width, this->cursorLineRows);
+        this->cursorLineWidth = width;
+    }
+    return this->cursorLineRows;
+}
+
+size_t TextArea::CursorRow() {
+    /* the row within the cursor's own line */
+    auto& rows = this->CursorLineRows();
+    size_t position = this->current.Position();
+    size_t row = 0;
+    while (row + 1 < rows.size() && rows[row + 1].index <= position) {
+        ++row;
+    }
+    return row;
+}
+
+void TextArea::ScrollToCursor() {
+    size_t height = (size_t) std::max(1, this->GetContentHeight());
+    size_t line = this->above.size();
+    size_t top = this->GetScrollPosition().firstVisibleEntryIndex;
+
+    if (line <= top) {
+        top = line;
+    }
+    else {
+        /* walk upwards from the cursor until we reach the current top, or
+        run out of room; at most a screenful of lines is ever wrapped */
+        size_t used = this->CursorRow() + 1;
+        size_t first = line;
+        while (first > top) {
+            size_t count = this->RowCount(first - 1);
+            if (used + count > height) {
+                break;
+            }
+            used += count;
+            --first;
+        }
+        top = first;
+    }
+
+    /* drawn once per pass through the main loop, however many edits and
+    cursor moves happen before then */
+    this->pendingTop = top;
+    Window::MessageQueue().Debounce(
+        Message::Create(this, MESSAGE_DRAW_PAGE, 0, 0), 0);
+}
+
+void TextArea::ProcessMessage(IMessage& message) {
+    if (message.Type() == MESSAGE_DRAW_PAGE) {
+        this->DrawPage(this->pendingTop);
+    }
+    else {
+        ScrollableWindow::ProcessMessage(message);
+    }
+}
+
+void TextArea::DrawPage(size_t index) {
+    auto& pos = this->GetMutableScrollPosition();
+    this->GetScrollAdapter().DrawPage(this, index, pos);
+
+    /* cache where the cursor ended up, for Row() and Position() */
+    size_t height = (size_t) std::max(1, this->GetContentHeight());
+    size_t width = (size_t) std::max(1, this->GetContentWidth());
+    size_t line = this->above.size();
+    size_t row = 0;
+
+    for (size_t i = pos.firstVisibleEntryIndex; i < line && row < height; i++) {
+        row += this->RowCount(i);
+    }
+
+    size_t cursorLineRow = this->CursorRow();
+    size_t start = this->CursorLineRows()[cursorLineRow].column;
+    row += cursorLineRow;
+
+    this->cursorRow = std::min(row, height - 1);
+    this->cursorColumn = std::min(
+        this->current.Column() - std::min(start, this->current.Column()),
+        width - 1);
+
+    this->Invalidate();
+}
+
+bool TextArea::Undo() {
+    auto transaction = this->history.Undo();
+    if (transaction) {
+        this->Apply(*transaction, true);
+        return true;
+    }
+    return false;
+}
+
+bool TextArea::Redo() {
+    auto transaction = this->history.Redo();
+    if (transaction) {
+        this->Apply(*transaction, false);
+        return true;
+    }
+    return false;
+}
+
+void TextArea::Apply(const EditHistory::Transaction& transaction, bool undo) {
+    /* undo reverts the edits in reverse order; redo replays them */
+    size_t count = transaction.size();
+    for (size_t i = 0; i < count; i++) {
+        auto& edit = transaction[undo ? count - 1 - i : i];
+        bool insert = (edit.type == EditHistory::Edit::Insert) != undo;
+
+        this->MoveToLine(edit.line);
+        this->current.MoveTo(edit.column);
+
+        if (insert) {
+            this->Insert(edit.text);
+        }
+        else {
+            this->EraseForward(edit.length);
+            this->preferredColumn = this->current.Position();
+        }
+    }
+
+    this->Changed();
+}
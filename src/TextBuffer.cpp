@@ -0,0 +1,282 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include <cursespp/TextBuffer.h>
+#include <cursespp/Text.h>
+#include <f8n/str/utf.h>
+#include <algorithm>
+
+using namespace cursespp;
+using namespace f8n::utf;
+
+const size_t TextBuffer::npos;
+
+TextBuffer::TextBuffer()
+: beforeColumns(0)
+, afterColumns(0)
+, dirty(false) {
+}
+
+void TextBuffer::Assign(const std::string& text) {
+    this->Clear();
+    this->Insert(text);
+}
+
+void TextBuffer::Clear() {
+    this->before.clear();
+    this->after.clear();
+    this->beforeBytes.clear();
+    this->afterBytes.clear();
+    this->beforeColumns = this->afterColumns = 0;
+    this->text.clear();
+    this->dirty = false;
+}
+
+size_t TextBuffer::Insert(const std::string& text, size_t maxColumns) {
+    size_t total = this->Columns();
+    size_t count = 0;
+
+    auto it = text.begin();
+    auto end = text.end();
+
+    this->before.reserve(this->before.size() + text.size());
+    this->beforeBytes.reserve(this->beforeBytes.size() + text.size());
+
+    while (it != end) {
+        auto prev = it;
+        size_t columns = 1;
+
+        try {
+            columns = text::Columns(utf8::next(it, end));
+        }
+        catch (...) {
+            /* invalid encoding, just treat as a single char */
+            it = prev + 1;
+        }
+
+        Glyph glyph;
+        glyph.bytes = (uint8_t) (it - prev);
+        glyph.columns = (uint8_t) columns;
+
+        if (maxColumns != npos && total + glyph.columns > maxColumns) {
+            break;
+        }
+
+        this->beforeBytes.append(prev, it);
+        this->before.push_back(glyph);
+        this->beforeColumns += glyph.columns;
+        total += glyph.columns;
+        ++count;
+    }
+
+    if (count) {
+        this->Dirty();
+    }
+
+    return count;
+}
+
+bool TextBuffer::EraseBefore() {
+    if (this->before.empty()) {
+        return false;
+    }
+
+    Glyph glyph = this->before.back();
+    this->before.pop_back();
+    this->beforeBytes.resize(this->beforeBytes.size() - glyph.bytes);
+    this->beforeColumns -= glyph.columns;
+    this->Dirty();
+    return true;
+}
+
+bool TextBuffer::EraseAfter() {
+    if (this->after.empty()) {
+        return false;
+    }
+
+    Glyph glyph = this->after.back();
+    this->after.pop_back();
+    this->afterBytes.resize(this->afterBytes.size() - glyph.bytes);
+    this->afterColumns -= glyph.columns;
+    this->Dirty();
+    return true;
+}
+
+bool TextBuffer::MoveTo(size_t position) {
+    position = std::min(position, this->Length());
+
+    if (position == this->before.size()) {
+        return false;
+    }
+
+    /* shuffle characters across the gap one at a time. the byte ranges are
+    copied reversed, which restores their original order on the way back */
+    while (this->before.size() > position) {
+        Glyph glyph = this->before.back();
+        size_t offset = this->beforeBytes.size() - glyph.bytes;
+        this->afterBytes.append(this->beforeBytes.rbegin(), this->beforeBytes.rbegin() + glyph.bytes);
+        this->beforeBytes.resize(offset);
+        this->before.pop_back();
+        this->after.push_back(glyph);
+        this->beforeColumns -= glyph.columns;
+        this->afterColumns += glyph.columns;
+    }
+
+    while (this->before.size() < position) {
+        Glyph glyph = this->after.back();
+        size_t offset = this->afterBytes.size() - glyph.bytes;
+        this->beforeBytes.append(this->afterBytes.rbegin(), this->afterBytes.rbegin() + glyph.bytes);
+        this->afterBytes.resize(offset);
+        this->after.pop_back();
+        this->before.push_back(glyph);
+        this->afterColumns -= glyph.columns;
+        this->beforeColumns += glyph.columns;
+    }
+
+    return true;
+}
+
+const std::string& TextBuffer::Text() const {
+    if (this->dirty) {
+        this->text.clear();
+        this->text.reserve(this->beforeBytes.size() + this->afterBytes.size());
+        this->text.append(this->beforeBytes);
+        this->text.append(this->afterBytes.rbegin(), this->afterBytes.rend());
+        this->dirty = false;
+    }
+    return this->text;
+}
+
+std::string TextBuffer::Slice(size_t start, size_t maxColumns, size_t* columns) const {
+    return this->Copy(start, npos, maxColumns, columns);
+}
+
+std::string TextBuffer::Range(size_t start, size_t count) const {
+    return this->Copy(start, count, npos, nullptr);
+}
+
+std::string TextBuffer::Copy(size_t start, size_t maxCount, size_t maxColumns, size_t* columns) const {
+    std::string result;
+    size_t used = 0, count = 0;
+    size_t index = start;
+
+    if (index < this->before.size()) {
+        /* walk back from the cursor to find where `start` begins */
+        size_t bytes = 0;
+        for (size_t i = this->before.size(); i > index; i--) {
+            bytes += this->before[i - 1].bytes;
+        }
+
+        size_t offset = this->beforeBytes.size() - bytes;
+        for (; index < this->before.size() && count < maxCount; index++) {
+            const Glyph& glyph = this->before[index];
+            if (used + glyph.columns > maxColumns) {
+                break;
+            }
+            result.append(this->beforeBytes, offset, glyph.bytes);
+            offset += glyph.bytes;
+            used += glyph.columns;
+            ++count;
+        }
+    }
+
+    if (index >= this->before.size() && used < maxColumns && count < maxCount) {
+        /* the tail is stored back-to-front; skip forward to `start` if
+        it's past the cursor, then copy out in order */
+        size_t skip = index - this->before.size();
+        size_t consumed = 0;
+        size_t i = this->after.size();
+
+        while (i > 0 && skip > 0) {
+            consumed += this->after[--i].bytes;
+            --skip;
+        }
+
+        while (i > 0 && count < maxCount) {
+            const Glyph& glyph = this->after[--i];
+            if (used + glyph.columns > maxColumns) {
+                break;
+            }
+            auto from = this->afterBytes.rbegin() + consumed;
+            result.append(from, from + glyph.bytes);
+            consumed += glyph.bytes;
+            used += glyph.columns;
+            ++count;
+        }
+    }
+
+    if (columns) {
+        *columns = used;
+    }
+
+    return result;
+}
+
+size_t TextBuffer::VisibleStart(size_t width, size_t* cursorColumn) const {
+    /* keep one cell free for the cursor itself */
+    size_t available = width > 0 ? width - 1 : 0;
+    size_t start = this->before.size();
+    size_t used = 0;
+
+    while (start > 0 && used + this->before[start - 1].columns <= available) {
+        used += this->before[--start].columns;
+    }
+
+    if (cursorColumn) {
+        *cursorColumn = used;
+    }
+
+    return start;
+}
+
+size_t TextBuffer::PositionAt(size_t start, size_t column) const {
+    size_t length = this->Length();
+    size_t position = std::min(start, length);
+    size_t used = 0;
+
+    while (position < length) {
+        const Glyph& glyph = (position < this->before.size())
+            ? this->before[position]
+            : this->after[this->after.size() - 1 - (position - this->before.size())];
+
+        if (used + glyph.columns > column) {
+            break;
+        }
+
+        used += glyph.columns;
+        ++position;
+    }
+
+    return position;
+}
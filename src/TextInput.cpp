@@ -32,43 +32,18 @@
 //
 //////////////////////////////////////////////////////////////////////////////
 
-#include <limits.h>
-
 #include <cursespp/Screen.h>
 #include <cursespp/Colors.h>
+#include <cursespp/Draw.h>
 #include <cursespp/TextInput.h>
 #include <f8n/str/utf.h>
 
 using namespace cursespp;
 using namespace f8n::utf;
 
-inline static bool removeUtf8Char(std::string& value, size_t position) {
-    /* optimize the normal case, at the end... */
-    if (position >= value.size()) {
-        std::string::iterator it = value.end();
-        std::string::iterator start = value.begin();
-        if (it != start) {
-            utf8::prior(it, start);
-            value = std::string(value.begin(), it);
-            return true;
-        }
-    }
-    else {
-        size_t offset = u8offset(value, position - 1);
-        if (offset != std::string::npos) {
-            size_t end = u8offset(value, position);
-            value.erase(offset, end - offset);
-            return true;
-        }
-    }
-
-    return false;
-}
 
 TextInput::TextInput(TextInput::Style style, IInput::InputMode inputMode)
 : Window()
-, bufferLength(0)
-, position(0)
 , style(style)
 , inputMode(inputMode)
 , enterEnabled(true)
@@ -85,60 +60,80 @@ TextInput::TextInput(IInput::InputMode inputMode)
 TextInput::~TextInput() {
 }
 
+void TextInput::SetAutocomplete(IAutocompleteProviderPtr provider, size_t limit) {
+    this->autocomplete.reset();
+
+    if (provider) {
+        this->autocomplete = std::make_shared<Autocomplete>(this, provider, limit);
+    }
+}
+
+void TextInput::Blur() {
+    Window::Blur();
+
+    if (this->autocomplete) {
+        this->autocomplete->Hide();
+    }
+}
+
+void TextInput::OnVisibilityChanged(bool visible) {
+    Window::OnVisibilityChanged(visible);
+
+    if (!visible && this->autocomplete) {
+        this->autocomplete->Hide();
+    }
+}
+
 void TextInput::OnRedraw() {
     WINDOW* c = this->GetContent();
     werase(c);
 
-    std::string trimmed;
     int contentWidth = GetContentWidth();
-    int columns = u8cols(buffer);
 
-    /* if the string is larger than our width, we gotta trim it for
-    display purposes... */
-    if (position > contentWidth) {
-        trimmed = u8substr(this->buffer, position - contentWidth, INT_MAX);
-    }
-    else {
-        trimmed = buffer;
-    }
+    /* only the visible slice around the cursor is materialized; the cost
+    is proportional to the window width, not the length of the text. */
+    size_t columns = 0;
+    size_t start = this->buffer.VisibleStart(std::max(0, contentWidth));
+    std::string trimmed = this->buffer.Slice(start, std::max(0, contentWidth), &columns);
 
-    if (!columns && hintText.size()) {
+    if (this->buffer.Empty() && hintText.size()) {
         /* draw the hint if we have one and there's no string yet */
         int64_t color = Color(Color::TextDisabled);
         wattron(c, color);
         wmove(c, 0, 0);
-        checked_waddstr(c, u8substr(hintText, 0, contentWidth).c_str());
+        draw::Text(c, u8substr(hintText, 0, contentWidth));
         wattroff(c, color);
     }
     else {
-        /* mask the string if we're in password mode */
+        /* draw the offset/trimmed string, masked if we're in password mode */
         if (inputMode == InputPassword) {
-            trimmed = std::string(columns, '*');
+            draw::Repeat(c, '*', columns);
+        }
+        else {
+            draw::Text(c, trimmed);
         }
 
         /* if we're in "Line" mode and the string is short, pad the
         end with a bunch of underscores */
         if (style == StyleLine) {
-            int remaining = contentWidth - columns;
+            int remaining = contentWidth - (int) columns;
             if (remaining > 0) {
-                trimmed += std::string(remaining, '_');
+                draw::Repeat(c, '_', (size_t) remaining);
             }
         }
-
-        /* finally, draw the offset/trimmed, potentially masked, padded
-        string to the output */
-        checked_waddstr(c, trimmed.c_str());
     }
 }
 
 size_t TextInput::Length() {
-    return this->bufferLength;
+    return this->buffer.Length();
 }
 
 size_t TextInput::Position() {
     /* note we return the COLUMN offset, not the physical or logical
-    character offset! */
-    return u8cols(u8substr(this->buffer, 0, this->position));
+    character offset! it's relative to the visible portion of the text */
+    size_t column = 0;
+    this->buffer.VisibleStart(std::max(0, this->GetContentWidth()), &column);
+    return column;
 }
 
 bool TextInput::Write(const std::string& key) {
@@ -152,26 +147,20 @@ bool TextInput::Write(const std::string& key) {
             if (std::find(bl.begin(), bl.end(), key) != bl.end()) {
                 return false;
             }
-            this->buffer = key;
-            this->bufferLength = len;
-            this->position = len;
+            this->buffer.Assign(key);
         }
         else {
             if (truncate) {
-                int cols = u8cols(this->buffer);
-                if (cols >= this->GetWidth()) {
+                if ((int) this->buffer.Columns() >= this->GetWidth()) {
                     return false;
                 }
             }
 
-            size_t offset = u8offset(this->buffer, this->position);
-            offset = (offset == std::string::npos) ? 0 : offset;
-            this->buffer.insert(offset, key);
-            this->bufferLength = u8len(buffer);
-            this->position += len;
+            this->history.Insert(0, this->buffer.Position(), key);
+            this->buffer.Insert(key);
         }
 
-        this->TextChanged(this, this->buffer);
+        this->TextChanged(this, this->buffer.Text());
         this->Redraw();
         return true;
     }
@@ -179,6 +168,46 @@ bool TextInput::Write(const std::string& key) {
     return false;
 }
 
+bool TextInput::Paste(const std::string& text) {
+    if (this->inputMode == InputRaw) {
+        return false;
+    }
+
+    /* single line: line breaks and tabs become spaces, other control
+    characters are dropped. */
+    std::string sanitized;
+    sanitized.reserve(text.size());
+    for (char c : text) {
+        if (c == '\n' || c == '\t') {
+            sanitized += ' ';
+        }
+        else if ((unsigned char) c >= 0x20 && c != 0x7f) {
+            sanitized += c;
+        }
+    }
+
+    size_t maxColumns = truncate
+        ? (size_t) std::max(0, this->GetWidth())
+        : TextBuffer::npos;
+
+    size_t position = this->buffer.Position();
+    size_t count = this->buffer.Insert(sanitized, maxColumns);
+
+    if (!count) {
+        return true; /* consumed, but nothing fit */
+    }
+
+    /* a paste is always its own undo step */
+    this->history.Break();
+    this->history.Insert(0, position, this->buffer.Range(position, count));
+    this->history.Break();
+
+    /* one change notification and one redraw for the whole block */
+    this->TextChanged(this, this->buffer.Text());
+    this->Redraw();
+    return true;
+}
+
 void TextInput::SetTruncate(bool truncate) {
     if (this->truncate != truncate) {
         this->truncate = truncate;
@@ -193,27 +222,49 @@ void TextInput::SetRawKeyBlacklist(const std::vector<std::string>&& blacklist) {
     this->rawBlacklist = blacklist;
 }
 
-bool TextInput::KeyPress(const std::string& key) {
+bool TextInput::KeyPress(KeyId key) {
     if (this->inputMode == InputMode::InputRaw) {
         return false;
     }
 
-    if (key == "M-KEY_BACKSPACE") {
-        this->SetText("");
+    auto& keys = NavigationKeys();
+
+    if (this->autocomplete && this->autocomplete->KeyPress(key)) {
         return true;
     }
-    else if (key == "KEY_BACKSPACE") {
-        if (this->position > 0) {
-            if (removeUtf8Char(this->buffer, this->position)) {
-                --this->bufferLength;
-                this->Redraw();
-                this->position = std::max(0, this->position - 1);
-                this->TextChanged(this, this->buffer);
-            }
+
+    if (keys.Undo(key)) {
+        this->Undo();
+        return true;
+    }
+    else if (keys.Redo(key)) {
+        this->Redo();
+        return true;
+    }
+    else if (key == key::MetaBackspace) {
+        if (!this->buffer.Empty()) {
+            /* unlike SetText(), this one can be undone */
+            this->history.Break();
+            this->history.Erase(0, 0, this->buffer.Text());
+            this->history.Break();
+            this->buffer.Clear();
+            this->TextChanged(this, this->buffer.Text());
+            this->Redraw();
         }
         return true;
     }
-    else if (key == "KEY_ENTER") {
+    else if (key == key::Backspace) {
+        size_t position = this->buffer.Position();
+        if (position > 0) {
+            this->history.Erase(0, position - 1, this->buffer.Range(position - 1, 1));
+        }
+        if (this->buffer.EraseBefore()) {
+            this->Redraw();
+            this->TextChanged(this, this->buffer.Text());
+        }
+        return true;
+    }
+    else if (key == key::Enter) {
         if (enterEnabled) {
             this->EnterPressed(this);
             return true;
@@ -222,28 +273,32 @@ bool TextInput::KeyPress(const std::string& key) {
             return false;
         }
     }
-    else if (key == "KEY_LEFT") {
+    else if (key == key::Left) {
         return this->OffsetPosition(-1);
     }
-    else if (key == "KEY_RIGHT") {
+    else if (key == key::Right) {
         return this->OffsetPosition(1);
     }
-    else if (key == "KEY_HOME") {
-        this->position = 0;
+    else if (key == key::Home) {
+        this->history.Break();
+        this->buffer.MoveTo(0);
         this->Redraw();
         return true;
     }
-    else if (key == "KEY_END") {
-        this->position = this->bufferLength;
+    else if (key == key::End) {
+        this->history.Break();
+        this->buffer.MoveTo(this->buffer.Length());
         this->Redraw();
         return true;
     }
-    else if (key == "KEY_DC") {
-        if ((int) this->bufferLength > this->position) {
-            removeUtf8Char(this->buffer, this->position + 1);
-            this->bufferLength = u8len(buffer);
+    else if (key == key::Delete) {
+        size_t position = this->buffer.Position();
+        if (position < this->buffer.Length()) {
+            this->history.Erase(0, position, this->buffer.Range(position, 1));
+        }
+        if (this->buffer.EraseAfter()) {
             this->Redraw();
-            this->TextChanged(this, this->buffer);
+            this->TextChanged(this, this->buffer.Text());
             return true;
         }
     }
@@ -252,11 +307,11 @@ bool TextInput::KeyPress(const std::string& key) {
 }
 
 bool TextInput::OffsetPosition(int delta) {
-    int actual = this->position + delta;
-    actual = std::max(0, std::min((int) this->bufferLength, actual));
+    int actual = (int) this->buffer.Position() + delta;
+    actual = std::max(0, std::min((int) this->buffer.Length(), actual));
 
-    if (this->position != actual) {
-        this->position = actual;
+    if (this->buffer.MoveTo((size_t) actual)) {
+        this->history.Break();
         this->Redraw();
         return true; /* moved */
     }
@@ -265,15 +320,34 @@ bool TextInput::OffsetPosition(int delta) {
 }
 
 void TextInput::SetText(const std::string& value) {
-    if (value != this->buffer) {
-        this->buffer = value;
-        this->bufferLength = u8len(buffer);
-        this->position = this->bufferLength;
-        this->TextChanged(this, this->buffer);
+    if (value != this->buffer.Text()) {
+        this->history.Clear();
+        this->buffer.Assign(value);
+        this->TextChanged(this, this->buffer.Text());
         this->Redraw();
     }
 }
 
+void TextInput::Replace(const std::string& value) {
+    if (value == this->buffer.Text()) {
+        return;
+    }
+
+    if (this->inputMode != InputRaw) {
+        /* one transaction, so a single undo restores the old text */
+        this->history.Break();
+        this->history.BeginGroup();
+        this->history.Erase(0, 0, this->buffer.Text());
+        this->history.Insert(0, 0, value);
+        this->history.EndGroup();
+        this->history.Break();
+    }
+
+    this->buffer.Assign(value);
+    this->TextChanged(this, this->buffer.Text());
+    this->Redraw();
+}
+
 void TextInput::SetHint(const std::string& hint) {
     this->hintText = hint;
     this->Redraw();
@@ -281,9 +355,60 @@ void TextInput::SetHint(const std::string& hint) {
 
 bool TextInput::MouseEvent(const IMouseHandler::Event& event) {
     if (event.Button1Clicked()) {
-        this->position = std::max(0, std::min((int)this->bufferLength, event.x));
+        size_t start = this->buffer.VisibleStart(std::max(0, this->GetContentWidth()));
+        this->buffer.MoveTo(this->buffer.PositionAt(start, (size_t) std::max(0, event.x)));
+        this->history.Break();
         this->FocusInParent();
         return true;
     }
     return false;
-}
\ No newline at end of file
+}
+
+bool TextInput::Undo() {
+    if (this->inputMode == InputRaw) {
+        return false;
+    }
+
+    auto transaction = this->history.Undo();
+    if (transaction) {
+        this->Apply(*transaction, true);
+        return true;
+    }
+    return false;
+}
+
+bool TextInput::Redo() {
+    if (this->inputMode == InputRaw) {
+        return false;
+    }
+
+    auto transaction = this->history.Redo();
+    if (transaction) {
+        this->Apply(*transaction, false);
+        return true;
+    }
+    return false;
+}
+
+void TextInput::Apply(const EditHistory::Transaction& transaction, bool undo) {
+    /* undo reverts the edits in reverse order; redo replays them */
+    size_t count = transaction.size();
+    for (size_t i = 0; i < count; i++) {
+        auto& edit = transaction[undo ? count - 1 - i : i];
+        bool insert = (edit.type == EditHistory::Edit::Insert) != undo;
+
+        if (insert) {
+            this->buffer.MoveTo(edit.column);
+            this->buffer.Insert(edit.text);
+        }
+        else {
+            this->buffer.MoveTo(edit.column + edit.length);
+            for (size_t j = 0; j < edit.length; j++) {
+                this->buffer.EraseBefore();
+            }
+        }
+    }
+
+    this->TextChanged(this, this->buffer.Text());
+    this->Redraw();
+}
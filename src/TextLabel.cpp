@@ -34,6 +34,7 @@
 
 #include <cursespp/Screen.h>
 #include <cursespp/Colors.h>
+#include <cursespp/Draw.h>
 #include <cursespp/Text.h>
 #include <cursespp/ILayout.h>
 
@@ -72,9 +73,6 @@ void TextLabel::ApplyDefaultStyle() {
 }
 
 void TextLabel::OnRedraw() {
-    std::string aligned = text::Align(
-        this->buffer, alignment, this->GetContentWidth());
-
     WINDOW* c = this->GetContent();
 
     Color color = this->IsFocused()
@@ -84,7 +82,7 @@ void TextLabel::OnRedraw() {
     wattron(c, color);
     if (this->bold) { wattron(c, A_BOLD); }
     wmove(c, 0, 0);
-    checked_waddstr(c, aligned.c_str());
+    draw::Aligned(c, this->buffer, alignment, this->GetContentWidth());
     if (this->bold) { wattroff(c, A_BOLD); }
     wattroff(c, color);
 }
@@ -115,9 +113,9 @@ void TextLabel::SetBold(bool bold) {
     }
 }
 
-bool TextLabel::KeyPress(const std::string& key) {
+bool TextLabel::KeyPress(KeyId key) {
     if (this->IsFocused()) {
-        if (key == " " || key == "KEY_ENTER") {
+        if (key == key::Space || key == key::Enter) {
             this->Activated(this);
             return true;
         }
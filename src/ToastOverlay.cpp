@@ -33,6 +33,7 @@
 //////////////////////////////////////////////////////////////////////////////
 
 #include <cursespp/App.h>
+#include <cursespp/Draw.h>
 #include <cursespp/ToastOverlay.h>
 #include <cursespp/Colors.h>
 #include <cursespp/Screen.h>
@@ -46,8 +47,8 @@ using namespace f8n::runtime;
 using namespace f8n::utf;
 
 void ToastOverlay::Show(const std::string& text, int durationMs) {
-    std::shared_ptr<ToastOverlay> overlay(new ToastOverlay(text, durationMs));
-    App::Overlays().Push(overlay);
+    /* one shared toast, so a burst of these doesn't stack up overlays */
+    App::Notifications().Post(text, durationMs);
 }
 
 ToastOverlay::ToastOverlay(const std::string& text, long durationMs) {
@@ -74,7 +75,7 @@ void ToastOverlay::Layout() {
     }
 }
 
-bool ToastOverlay::KeyPress(const std::string& key) {
+bool ToastOverlay::KeyPress(KeyId key) {
     this->Dismiss(); /* any key closes */
     this->Remove(TOAST_MESSAGE_HIDE);
     return true;
@@ -89,6 +90,22 @@ void ToastOverlay::OnVisibilityChanged(bool visible) {
     }
 }
 
+void ToastOverlay::OnDismissed() {
+    this->Dismissed(this);
+}
+
+void ToastOverlay::Close() {
+    this->Remove(TOAST_MESSAGE_HIDE);
+    this->Dismiss();
+}
+
+void ToastOverlay::SetText(const std::string& text) {
+    this->title = text;
+    if (this->IsVisible()) {
+        this->Layout();
+    }
+}
+
 void ToastOverlay::ProcessMessage(IMessage &message) {
     if (message.Type() == TOAST_MESSAGE_HIDE) {
         this->Dismiss();
@@ -113,6 +130,6 @@ void ToastOverlay::OnRedraw() {
 
      for (int i = 0; i < (int) this->titleLines.size(); i++) {
          wmove(c, i, 1);
-         checked_wprintw(c, text::Ellipsize(this->titleLines[i], this->width - 4).c_str());
+         draw::Text(c, text::Ellipsize(this->titleLines[i], this->width - 4));
      }
 }
@@ -33,6 +33,7 @@
 //////////////////////////////////////////////////////////////////////////////
 
 #include <cursespp/Window.h>
+#include <cursespp/Draw.h>
 #include <cursespp/IWindowGroup.h>
 #include <cursespp/IInput.h>
 #include <cursespp/ILayout.h>
@@ -58,6 +59,9 @@ static Window* top = nullptr;
 static Window* focused = nullptr;
 
 static MessageQueue messageQueue;
+static HitTestIndex hitTestIndex;
+static KeymapDispatcher keymaps; /* after messageQueue: removes itself from it */
+static CommandRegistry commands;
 static std::shared_ptr<INavigationKeys> keys;
 
 #define ENABLE_BOUNDS_CHECK 1
@@ -69,7 +73,7 @@ static inline void DrawCursor(IInput* input) {
             WINDOW* content = inputWindow->GetContent();
             curs_set(1);
             wtimeout(content, IDLE_TIMEOUT_MS);
-            wmove(content, 0, input->Position());
+            wmove(content, (int) input->Row(), (int) input->Position());
         }
     }
     else {
@@ -83,7 +87,7 @@ static inline void DrawTooSmall() {
     wclear(stdscr);
     wmove(stdscr, 0, 0);
     wattron(stdscr, color);
-    waddstr(stdscr, error.c_str());
+    draw::Text(stdscr, error);
     wattroff(stdscr, color);
 }
 
@@ -122,6 +126,22 @@ void Window::Unfreeze() {
     }
 }
 
+HitTestIndex& Window::HitTest() {
+    return hitTestIndex;
+}
+
+KeymapDispatcher& Window::Keymaps() {
+    return keymaps;
+}
+
+CommandRegistry& Window::Commands() {
+    return commands;
+}
+
+void Window::SetKeymap(std::shared_ptr<Keymap> keymap) {
+    keymaps.Set(this, keymap);
+}
+
 IMessageQueue& Window::MessageQueue() {
     return messageQueue;
 }
@@ -150,6 +170,8 @@ Window::Window(IWindow *parent) {
 
 Window::~Window() {
     messageQueue.Remove(this);
+    keymaps.Remove(this);
+    commands.Remove(this);
     if (::top == this) { top = nullptr; }
     if (::focused == this) { focused = nullptr; }
     this->Destroy();
@@ -179,6 +201,7 @@ void Window::BringToTop() {
             top_panel(this->contentPanel);
         }
 
+        hitTestIndex.Raise(this);
         ::top = this;
     }
 }
@@ -194,6 +217,8 @@ void Window::SendToBottom() {
         if (this->contentPanel != this->framePanel) {
             bottom_panel(this->framePanel);
         }
+
+        hitTestIndex.Lower(this);
     }
 }
 
@@ -434,9 +459,10 @@ void Window::DrawFrameAndTitle() {
     if (titleLen > 0) {
         int max = this->width - 4; /* 4 = corner + space + space + corner */
         if (max > 3) { /* 3 = first character plus ellipse (e.g. 'F..')*/
-            std::string adjusted = " " + text::Ellipsize(this->title, (size_t) max - 2) + " ";
             wmove(this->frame, 0, 2);
-            checked_waddstr(this->frame, adjusted.c_str());
+            draw::Fill(this->frame, 1);
+            draw::Text(this->frame, text::Ellipsize(this->title, (size_t) max - 2));
+            draw::Fill(this->frame, 1);
         }
     }
 
@@ -670,6 +696,13 @@ void Window::Create() {
 
         this->framePanel = new_panel(this->frame);
 
+        hitTestIndex.Add(
+            this,
+            absoluteXOffset + this->x,
+            absoluteYOffset + this->y,
+            this->width,
+            this->height);
+
         /* if we were asked not to draw a frame, we'll set the frame equal to
         the content view, and use the content views colors*/
 
@@ -736,6 +769,7 @@ void Window::Hide() {
 
 void Window::Destroy() {
     if (this->frame) {
+        hitTestIndex.Remove(this);
         del_panel(this->framePanel);
         delwin(this->frame);
 
@@ -863,6 +897,20 @@ static class DefaultNavigationKeys : public INavigationKeys {
         virtual bool Home(const std::string& key) override { return Home() == key; }
         virtual bool End(const std::string& key) override { return End() == key; }
 
+        virtual bool Up(KeyId id) override { return id == key::Up; }
+        virtual bool Down(KeyId id) override { return id == key::Down; }
+        virtual bool Left(KeyId id) override { return id == key::Left; }
+        virtual bool Right(KeyId id) override { return id == key::Right; }
+        virtual bool Next(KeyId id) override { return id == nextId; }
+        virtual bool Prev(KeyId id) override { return id == key::BackTab; }
+        virtual bool Mode(KeyId id) override { return id == key::Escape; }
+        virtual bool PageUp(KeyId id) override { return id == key::PageUp; }
+        virtual bool PageDown(KeyId id) override { return id == key::PageDown; }
+        virtual bool Home(KeyId id) override { return id == key::Home; }
+        virtual bool End(KeyId id) override { return id == key::End; }
+        virtual bool Undo(KeyId id) override { return id == undoId; }
+        virtual bool Redo(KeyId id) override { return id == redoId; }
+
         virtual std::string Up() override { return "KEY_UP"; }
         virtual std::string Down() override { return "KEY_DOWN"; }
         virtual std::string Left() override { return "KEY_LEFT"; }
@@ -874,6 +922,11 @@ static class DefaultNavigationKeys : public INavigationKeys {
         virtual std::string PageDown() override { return "KEY_NPAGE"; }
         virtual std::string Home() override { return "KEY_HOME"; }
         virtual std::string End() override { return "KEY_END"; }
+
+    private:
+        const KeyId nextId { key::Intern("KEY_TAB") };
+        const KeyId undoId { key::Intern(INavigationKeys::Undo()) };
+        const KeyId redoId { key::Intern(INavigationKeys::Redo()) };
 } defaultNavigationKeys;
 
 INavigationKeys& Window::NavigationKeys() {
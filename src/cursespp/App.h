@@ -35,18 +35,25 @@
 #pragma once
 
 #include <queue>
+#include <memory>
 #include <functional>
 #include <cursespp/ILayout.h>
 #include <cursespp/IInput.h>
 #include <cursespp/IKeyHandler.h>
 #include <cursespp/OverlayStack.h>
 #include <cursespp/Colors.h>
+#include <cursespp/InputRecorder.h>
+#include <cursespp/InputReplayer.h>
+#include <cursespp/LatencyTracker.h>
+#include <cursespp/NotificationCenter.h>
+#include <cursespp/RawInput.h>
 
 namespace cursespp {
     class App {
         public:
             using KeyHandler = std::function<bool(const std::string&)>;
             using ResizeHandler = std::function<void()>;
+            using Clock = std::function<int64_t()>;
 
             App(const std::string& title);
             ~App(); /* do not subclass */
@@ -63,12 +70,37 @@ namespace cursespp {
             void SetMinimumSize(int width, int height);
             void SetMouseEnabled(bool enabled);
             bool IsOverlayVisible() { return this->state.overlay != nullptr; }
+
+            /* when enabled, the main layout is left alone while overlays come
+            and go: it isn't laid out or raised again when the last overlay is
+            dismissed (unless the screen was resized), and the window that was
+            focused before the first overlay was shown is focused again. */
+            void SetOverlaysPreserveLayout(bool preserve);
             void SetMinimizeToTray(bool minimizeToTray);
             std::string GetQuitKey();
             void SetQuitKey(const std::string& kn);
             void Minimize();
             void Restore();
 
+            /* headless mode renders to a null terminal of the specified size
+            instead of the controlling tty. must be called before Run(). */
+            void SetHeadless(bool headless, int width = 80, int height = 24);
+
+            /* recorded input is captured from the main loop as it is read.
+            a replayer replaces terminal input entirely, drives Now(), and
+            causes Run() to return once playback completes. */
+            void SetInputRecorder(std::shared_ptr<InputRecorder> recorder);
+            void SetInputReplayer(std::shared_ptr<InputReplayer> replayer);
+
+            /* input-to-screen latency tracing. results can be queried at any
+            time via Latency(), and are written to the specified file (or
+            stderr if empty) when the app exits. */
+            void SetLatencyTracing(bool enabled, const std::string& reportFilename = "");
+
+            /* reads the terminal directly instead of via wgetch(), and enables
+            bracketed paste. POSIX terminals only; must be called before Run(). */
+            void SetRawInputEnabled(bool enabled);
+
 #ifdef WIN32
             static bool Running(const std::string& uniqueId, const std::string& title);
             static bool Running(const std::string& title);
@@ -87,7 +119,15 @@ namespace cursespp {
             static App& Instance();
 
             static int64_t Now();
+            static void SetClock(Clock clock);
             static OverlayStack& Overlays();
+            static LatencyTracker& Latency();
+            static NotificationCenter& Notifications();
+
+            /* runs `task` on a thread owned by the app. it's joined when the
+            app shuts down rather than by whoever started it, so e.g. closing
+            an overlay never waits on its worker. main thread only. */
+            static void RunInBackground(std::function<void()> task);
 
         private:
             struct WindowState {
@@ -99,6 +139,10 @@ namespace cursespp {
                 IInput* input{ nullptr };
                 IKeyHandler* keyHandler{ nullptr };
 
+                inline IWindow* ActiveWindow() {
+                    return overlay ? overlayWindow : rootWindow;
+                }
+
                 inline ILayoutPtr ActiveLayout() {
                     /* if there's a visible overlay, it's always the current
                     layout and will consume all key events */
@@ -107,6 +151,13 @@ namespace cursespp {
             };
 
             void InitCurses();
+            void InitHeadless();
+            void ProcessResize(int width, int height);
+            bool ReadReplayedInput(std::string& kn, MEVENT& mouseEvent);
+            bool ReadRawInput(std::string& kn, MEVENT& mouseEvent);
+            void Paste(const std::string& text);
+            LatencyTracker::Category CategorizeInput(
+                const std::string& kn, bool overlay, bool wroteToInput);
             void UpdateFocusedWindow(IWindowPtr window);
             void EnsureFocusIsValid();
             void CheckShowOverlay();
@@ -116,6 +167,9 @@ namespace cursespp {
 
             std::queue<std::string> injectedKeys;
             WindowState state;
+            bool overlaysPreserveLayout{ false };
+            IWindowPtr focusBeforeOverlay;
+            int widthBeforeOverlay{ 0 }, heightBeforeOverlay{ 0 };
             KeyHandler keyHandler, keyHook;
             ResizeHandler resizeHandler;
             Colors::Mode colorMode { Colors::Palette };
@@ -125,6 +179,15 @@ namespace cursespp {
             int minWidth, minHeight;
             bool mouseEnabled{true};
             bool quit{false}, initialized{false};
+            bool headless{false};
+            int headlessWidth{80}, headlessHeight{24};
+            SCREEN* headlessScreen{nullptr};
+            FILE *headlessIn{nullptr}, *headlessOut{nullptr};
+            std::shared_ptr<InputRecorder> recorder;
+            std::shared_ptr<InputReplayer> replayer;
+            std::unique_ptr<RawInput> rawInput;
+            bool rawInputEnabled{false};
+            std::string latencyReportFilename;
 
 #ifdef WIN32
             int iconId;
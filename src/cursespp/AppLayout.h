@@ -53,7 +53,8 @@ namespace cursespp {
 
             virtual ~AppLayout();
 
-            virtual bool KeyPress(const std::string& key) override;
+            using LayoutBase::KeyPress;
+            virtual bool KeyPress(KeyId key) override;
             virtual void OnLayout() override;
             virtual cursespp::IWindowPtr GetFocus() override;
             virtual cursespp::IWindowPtr FocusNext() override;
@@ -0,0 +1,112 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cursespp/IAutocompleteProvider.h>
+#include <cursespp/KeyId.h>
+#include <f8n/runtime/IMessageTarget.h>
+#include <sigslot/sigslot.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace cursespp {
+    class TextInput;
+    class ListWindow;
+    class SimpleScrollAdapter;
+
+    /* drives suggestions for a TextInput. every text change cancels the
+    query in flight (if any) and hands the new text to a worker thread; when
+    results arrive they're posted back to the main loop through the message
+    queue and shown in a dropdown list under the input. only the newest
+    query's results are ever shown, so typing never waits on the provider.
+    while the dropdown is up, UP/DOWN move the selection, ENTER accepts it
+    and ESC dismisses it. */
+    class Autocomplete:
+        public f8n::runtime::IMessageTarget,
+        public sigslot::has_slots<>
+    {
+        public:
+            static const size_t DEFAULT_LIMIT = 8;
+
+            sigslot::signal2<Autocomplete*, std::string> SuggestionAccepted;
+
+            Autocomplete(
+                TextInput* input,
+                IAutocompleteProviderPtr provider,
+                size_t limit = DEFAULT_LIMIT);
+
+            virtual ~Autocomplete();
+
+            Autocomplete(const Autocomplete& other) = delete;
+            Autocomplete& operator=(const Autocomplete& other) = delete;
+
+            void SetMinimumLength(size_t length);
+
+            bool KeyPress(KeyId key);
+            bool IsVisible();
+            void Hide();
+
+            virtual void ProcessMessage(f8n::runtime::IMessage& message) override;
+
+        private:
+            void OnTextChanged(TextInput* input, std::string text);
+            void Query(const std::string& text);
+            void Cancel();
+            void Show(IAutocompleteProvider::Suggestions& suggestions);
+            void Accept(size_t index);
+            void OnEntryActivated(ListWindow* sender, size_t index);
+            void ThreadProc();
+
+            TextInput* input;
+            IAutocompleteProviderPtr provider;
+            size_t limit, minimumLength;
+            bool accepting;
+
+            std::shared_ptr<ListWindow> dropdown;
+            std::shared_ptr<SimpleScrollAdapter> adapter;
+            IAutocompleteProvider::Suggestions shown;
+
+            /* shared with the worker thread */
+            std::thread thread;
+            std::mutex mutex;
+            std::condition_variable condition;
+            std::string query;
+            std::shared_ptr<std::atomic<bool>> cancelled;
+            IAutocompleteProvider::Suggestions results;
+            uint64_t requested, completed;
+            bool pending, quit;
+    };
+}
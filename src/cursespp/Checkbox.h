@@ -54,7 +54,8 @@ namespace cursespp {
             virtual std::string GetText();
             virtual void SetChecked(bool checked);
             virtual bool IsChecked() { return this->checked; }
-            virtual bool KeyPress(const std::string& key);
+            using TextLabel::KeyPress;
+            virtual bool KeyPress(KeyId key);
             virtual bool MouseEvent(const IMouseHandler::Event& event);
 
         private:
@@ -0,0 +1,99 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cursespp/curses_config.h>
+#include <unordered_map>
+#include <vector>
+
+namespace cursespp {
+    /* hands out color pairs for arbitrary (foreground, background)
+    combinations on demand, from the pair ids above the fixed ones Theme
+    uses. lookups are a single hash probe; when the pairs run out the least
+    recently requested one is redefined. cells already drawn with an evicted
+    pair pick up its new colors on the next refresh, so content that's
+    redrawn every frame (which re-requests its pairs) is what this is for.
+
+    pair ids are kept below 256 so they can still be carried in attributes
+    via COLOR_PAIR() like every other Color; init_extended_pair() is used
+    where available so foreground and background may be any color number
+    the terminal supports. */
+    class ColorPairAllocator {
+        public:
+            /* may be passed as a background to track the current theme's
+            background; these pairs are redefined on theme switch. */
+            static const int ThemeBackground = -2;
+
+            ColorPairAllocator();
+
+            ColorPairAllocator(const ColorPairAllocator& other) = delete;
+            ColorPairAllocator& operator=(const ColorPairAllocator& other) = delete;
+
+            /* sets the range of pair ids to allocate from, [first, last).
+            forgets all existing pairs. */
+            void SetRange(int first, int last);
+
+            /* returns the pair id for the specified colors, defining it if
+            necessary, or 0 (the terminal's default pair) if no pairs are
+            available. */
+            int Acquire(int foreground, int background);
+
+            /* re-issues all live pairs, e.g. after start_color() or a theme
+            switch. ids stay the same, so values already handed out remain
+            valid. */
+            void Rebuild(int themeBackground);
+
+            void Clear();
+            size_t Size() const;
+            size_t Capacity() const;
+
+        private:
+            struct Slot {
+                int foreground, background;
+                int prev, next;
+            };
+
+            static uint64_t Key(int foreground, int background);
+
+            void Define(int pair, int foreground, int background);
+            void Unlink(int slot);
+            void PushFront(int slot);
+
+            std::unordered_map<uint64_t, int> pairs;
+            std::vector<Slot> slots;
+            int first, used, head, tail;
+            int themeBackground;
+    };
+}
@@ -108,7 +108,11 @@ namespace cursespp {
             enum Mode {
                 RGB,
                 Palette,
-                Basic
+                Basic,
+                /* 24-bit colors through a direct-color terminfo entry (e.g.
+                xterm-direct). falls back to RGB or Palette if the terminal
+                doesn't support it. */
+                DirectRGB
             };
 
             enum BgType {
@@ -117,7 +121,29 @@ namespace cursespp {
             };
 
             static void Init(Mode mode = Mode::Basic, BgType bgType = BgType::Theme);
+
+            /* themes are indexed in the background after Init(); if the theme
+            isn't available yet, it's applied as soon as indexing finishes. */
             static void SetTheme(const std::string& name);
+
+            /* the mode that was actually selected by Init(), after fallbacks */
+            static Mode GetMode();
+
+            /* returns the color number closest to the specified 24-bit color
+            in the current mode; exact in DirectRGB mode. */
+            static int Rgb(int r, int g, int b);
+
+            /* returns a color for an arbitrary foreground and background,
+            allocating a pair for it if necessary. see ColorPairAllocator;
+            pass ColorPairAllocator::ThemeBackground to follow the theme. */
+            static Color Pair(int foreground, int background = -1);
+
+            /* opt-in: watch the theme directories and re-apply the active
+            theme when its file changes. only the slots that changed are
+            re-initialized. currently linux only; a no-op elsewhere. */
+            static void WatchThemes(bool watch);
+
+            /* waits for indexing to finish if it hasn't already */
             static std::vector<std::string> ListThemes();
     };
 }
@@ -0,0 +1,123 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cursespp/Keymap.h>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cursespp {
+    class IWindow;
+
+    /* commands that layouts and windows declare, so they can be found and
+    run by name, e.g. from a CommandPaletteOverlay. a command either has an
+    action, which is bound to its key sequence (if any) in its owner's keymap
+    layer, or just the key sequence of a binding that's handled elsewhere (a
+    ShortcutsWindow entry, a DialogOverlay button, a KeyPress override). in
+    both cases Execute() runs the command through the same path its keys
+    would: the keymap binding itself, or the keys are injected into the main
+    loop. commands owned by a window are removed along with it.
+
+    Find() matches a query against command titles using an index that's
+    built once per registry generation: a trigram posting list for substring
+    matches, and a character mask per title to cheaply reject everything else
+    before fuzzy (subsequence) matching. */
+    class CommandRegistry {
+        public:
+            using Action = Keymap::Action;
+
+            struct Command {
+                std::string id;
+                std::string title;
+                std::string sequence;
+                IWindow* owner;
+                Action action;
+            };
+
+            using CommandList = std::vector<Command>;
+
+            struct Match {
+                size_t index; /* into Commands(); valid until the next change */
+                int score;
+            };
+
+            using MatchList = std::vector<Match>;
+
+            CommandRegistry();
+            virtual ~CommandRegistry();
+
+            CommandRegistry(const CommandRegistry& other) = delete;
+            CommandRegistry& operator=(const CommandRegistry& other) = delete;
+
+            bool Register(
+                IWindow* owner,
+                const std::string& id,
+                const std::string& title,
+                const std::string& sequence,
+                Action action = Action());
+
+            bool Unregister(const std::string& id);
+            void Remove(IWindow* owner);
+            void Clear();
+
+            const Command* Get(const std::string& id) const;
+            const CommandList& Commands() const { return this->commands; }
+            size_t Generation() const { return this->generation; }
+
+            bool Execute(const std::string& id);
+
+            /* ranked best first, capped at `limit`. an empty query matches
+            everything, in registration order. commands owned by a hidden
+            window are skipped. */
+            void Find(const std::string& query, size_t limit, MatchList& results);
+
+        private:
+            void BuildIndex();
+            void Erase(size_t index);
+
+            CommandList commands;
+            std::unordered_map<std::string, size_t> ids;
+            size_t generation;
+
+            /* search index, rebuilt lazily when the generation changes */
+            std::vector<std::string> titles;
+            std::vector<uint64_t> masks;
+            std::unordered_map<uint32_t, std::vector<uint32_t>> trigrams;
+            size_t indexedGeneration;
+    };
+}
@@ -37,9 +37,11 @@
 #include <cursespp/OverlayBase.h>
 #include <cursespp/TextLabel.h>
 #include <cursespp/ShortcutsWindow.h>
+#include <cursespp/Text.h>
 
 #include <vector>
 #include <map>
+#include <unordered_map>
 
 namespace cursespp {
     class DialogOverlay: public OverlayBase {
@@ -65,25 +67,51 @@ namespace cursespp {
 
             DialogOverlay& SetAutoDismiss(bool dismiss = true);
 
+            /* scrolls the message so the specified (unwrapped) line is at
+            the top. only needed for messages taller than the screen. */
+            DialogOverlay& ScrollToLine(size_t line);
+            size_t GetLineCount() const { return this->lineOffsets.size(); }
+
             virtual void Layout();
-            virtual bool KeyPress(const std::string& key);
+            using OverlayBase::KeyPress;
+            virtual bool KeyPress(KeyId key);
 
         protected:
             virtual void OnDismissed();
 
         private:
+            using Rows = std::vector<text::WrappedRow>;
+
             void Redraw();
             void RecalculateSize();
-            bool ProcessKey(const std::string& key);
+            bool ProcessKey(KeyId key);
+            bool ScrollKey(KeyId key);
+
+            void IndexLines();
+            const Rows& WrapLine(size_t line);
+            size_t CountRows(size_t maximum);
+            void ScrollDown(size_t rows);
+            void ScrollUp(size_t rows);
+            void ClampToEnd();
+            void PruneRows();
 
             std::string title;
             std::string message;
-            std::vector<std::string> messageLines;
+
+            /* the message is indexed by line up front (cheap), but lines are
+            only wrapped as they become visible. */
+            std::vector<size_t> lineOffsets;
+            std::unordered_map<size_t, Rows> wrapped;
+            size_t topLine, topRow;
+            size_t endLine, endRow;
+            bool endValid;
+            int wrapWidth, bodyHeight;
+            bool scrollable;
             std::shared_ptr<ShortcutsWindow> shortcuts;
             int width, height;
             bool autoDismiss;
             DismissCallback dismissCb;
 
-            std::map<std::string, ButtonCallback> buttons;
+            std::unordered_map<KeyId, ButtonCallback> buttons;
     };
 }
\ No newline at end of file
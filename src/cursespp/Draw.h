@@ -0,0 +1,65 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cursespp/curses_config.h>
+#include <cursespp/Text.h>
+#include <string>
+
+namespace cursespp {
+    namespace draw {
+        /* writes text verbatim at the cursor; unlike wprintw(), nothing in
+        it is treated as a format specifier. null windows are ignored. */
+        void Text(WINDOW* window, const char* str, size_t bytes);
+        void Text(WINDOW* window, const std::string& str);
+
+        /* writes `count` copies of a single-byte character in the current
+        attributes, without building a string. */
+        void Repeat(WINDOW* window, char ch, size_t count);
+
+        /* writes `columns` spaces in the current attributes. unlike
+        wclrtoeol(), which fills with the window's background, this keeps
+        highlighted rows highlighted. */
+        void Fill(WINDOW* window, size_t columns);
+
+        /* writes text whose width has already been measured, followed by
+        enough spaces to fill `width` columns. */
+        void Line(WINDOW* window, const std::string& str, size_t columns, size_t width);
+
+        /* equivalent to writing text::Align(str, align, width), but the
+        padding is filled in place instead of allocated. */
+        void Aligned(WINDOW* window, const std::string& str, text::TextAlign align, size_t width);
+    }
+}
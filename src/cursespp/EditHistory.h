@@ -0,0 +1,111 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace cursespp {
+    /* an undo/redo log for text editors. rather than snapshotting the text,
+    it records each insertion and erasure (only the affected characters) so
+    its cost is proportional to what was typed, not to the document size.
+    runs of typing or deleting are coalesced into a single edit, and edits
+    are grouped into transactions that are undone and redone as a unit.
+    when the log grows past its memory limit the oldest transactions are
+    discarded.
+
+    positions are (line, column) pairs in code points; single line editors
+    always use line 0. inserted or erased text may contain newlines. */
+    class EditHistory {
+        public:
+            static const size_t DEFAULT_MEMORY_LIMIT = 1024 * 1024;
+
+            struct Edit {
+                enum Type { Insert, Erase };
+
+                Type type;
+                size_t line, column;
+                size_t length; /* in code points */
+                std::string text;
+            };
+
+            using Transaction = std::vector<Edit>;
+
+            EditHistory(size_t memoryLimit = DEFAULT_MEMORY_LIMIT);
+
+            EditHistory(const EditHistory& other) = delete;
+            EditHistory& operator=(const EditHistory& other) = delete;
+
+            void Insert(size_t line, size_t column, const std::string& text);
+            void Erase(size_t line, size_t column, const std::string& text);
+
+            /* closes the current transaction; the next edit starts a new one.
+            editors call this when the cursor is moved. */
+            void Break();
+
+            /* everything between BeginGroup() and EndGroup() is one
+            transaction. groups may be nested. */
+            void BeginGroup();
+            void EndGroup();
+
+            bool CanUndo() const { return !this->undo.empty(); }
+            bool CanRedo() const { return !this->redo.empty(); }
+
+            /* return the transaction the caller needs to revert (in reverse
+            order) or re-apply (in order), or nullptr if there isn't one. the
+            pointer is valid until the history is next modified. */
+            const Transaction* Undo();
+            const Transaction* Redo();
+
+            void Clear();
+
+            void SetMemoryLimit(size_t bytes);
+            size_t GetMemoryLimit() const { return this->memoryLimit; }
+            size_t GetMemoryUsage() const { return this->memoryUsage; }
+
+        private:
+            void Add(Edit::Type type, size_t line, size_t column, const std::string& text);
+            bool Coalesce(Edit& last, Edit::Type type, size_t line, size_t column, const std::string& text, size_t length);
+            void ClearRedo();
+            void Trim();
+
+            std::deque<Transaction> undo;
+            std::vector<Transaction> redo;
+            size_t memoryLimit, memoryUsage;
+            int groupDepth;
+            bool open;
+    };
+}
@@ -0,0 +1,126 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cursespp/LayoutBase.h>
+
+#include <climits>
+#include <unordered_map>
+#include <vector>
+
+namespace cursespp {
+    /* a LayoutBase that arranges its children along a single axis using
+    per-child min/max/weight constraints, instead of hand-computed coordinates
+    in OnLayout(). grids are built by nesting a FlexLayout of one direction
+    inside a FlexLayout of the other. measure results are cached by available
+    size, and a layout pass only calls MoveAndResize() on children whose
+    bounds actually changed. */
+    class FlexLayout : public LayoutBase {
+        public:
+            enum Direction {
+                Horizontal,
+                Vertical
+            };
+
+            struct Constraints {
+                static const int UNBOUNDED = INT_MAX;
+
+                Constraints(int weight = 1, int min = 0, int max = UNBOUNDED)
+                : weight(weight), min(min), max(max) {
+                }
+
+                static Constraints Fixed(int size) {
+                    return Constraints(0, size, size);
+                }
+
+                bool operator==(const Constraints& other) const {
+                    return weight == other.weight && min == other.min && max == other.max;
+                }
+
+                int weight;
+                int min;
+                int max;
+            };
+
+            FlexLayout(Direction direction = Vertical, IWindow* parent = nullptr);
+            virtual ~FlexLayout();
+
+            void SetDirection(Direction direction);
+            Direction GetDirection() const { return this->direction; }
+
+            void SetSpacing(int spacing);
+            int GetSpacing() const { return this->spacing; }
+
+            bool AddWindow(IWindowPtr window, const Constraints& constraints);
+            void SetConstraints(IWindowPtr window, const Constraints& constraints);
+            Constraints GetConstraints(IWindowPtr window);
+
+            /* marks the cached measurements stale; the next Layout() will
+            re-measure, even if the available size didn't change. */
+            void InvalidateLayout();
+
+            /* IWindowGroup */
+            virtual bool AddWindow(IWindowPtr window) override;
+            virtual bool RemoveWindow(IWindowPtr window) override;
+
+        protected:
+            virtual void OnLayout() override;
+
+        private:
+            struct Item {
+                IWindowPtr window;
+                Constraints constraints;
+            };
+
+            struct Rect {
+                int x, y, width, height;
+            };
+
+            using Measurement = std::vector<Rect>;
+
+            const Measurement& Measure(int width, int height);
+            void Distribute(int available, std::vector<int>& sizes);
+            void Relayout();
+
+            Direction direction;
+            int spacing;
+            bool dirty;
+            bool layingOut;
+            int lastWidth, lastHeight;
+            int lastAbsoluteX, lastAbsoluteY;
+            std::vector<Item> items;
+            std::unordered_map<int64_t, Measurement> measureCache;
+    };
+}
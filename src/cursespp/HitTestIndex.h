@@ -0,0 +1,88 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace cursespp {
+    class IWindow;
+
+    /* screen-space index of on-screen window rects, used to resolve mouse
+    events without walking the window tree. the screen is divided into a
+    uniform grid of cells; each cell lists the windows that overlap it, so a
+    lookup only has to consider the handful of windows stacked at that spot.
+    windows are also assigned a z value that tracks the panel stack, so the
+    topmost window can be found even when windows overlap (e.g. overlays). */
+    class HitTestIndex {
+        public:
+            HitTestIndex(int cellWidth = 16, int cellHeight = 8);
+
+            HitTestIndex(const HitTestIndex& other) = delete;
+            HitTestIndex& operator=(const HitTestIndex& other) = delete;
+
+            void Add(IWindow* window, int x, int y, int width, int height);
+            void Remove(IWindow* window);
+            void Raise(IWindow* window);
+            void Lower(IWindow* window);
+            void Clear();
+
+            bool Contains(IWindow* window) const;
+            bool GetBounds(IWindow* window, int& x, int& y, int& width, int& height) const;
+
+            IWindow* TopmostAt(int x, int y) const;
+            void HitsAt(int x, int y, std::vector<IWindow*>& target) const;
+
+        private:
+            struct Entry {
+                int x, y, width, height;
+                int64_t z;
+            };
+
+            using Cell = std::vector<IWindow*>;
+
+            void Grow(int columns, int rows);
+            void Link(IWindow* window, const Entry& entry);
+            void Unlink(IWindow* window, const Entry& entry);
+            const Cell* CellAt(int x, int y) const;
+
+            std::unordered_map<IWindow*, Entry> entries;
+            std::vector<Cell> cells;
+            int cellWidth, cellHeight;
+            int columns, rows;
+            int64_t topZ, bottomZ;
+    };
+}
@@ -45,8 +45,17 @@ namespace cursespp {
 
             virtual ~IInput() { }
             virtual bool Write(const std::string& key) = 0;
+
+            /* inserts a block of pasted text in one operation. inputs that
+            don't support this return false, and the caller falls back to
+            writing the text one character at a time. */
+            virtual bool Paste(const std::string& text) { return false; }
             virtual size_t Length() = 0;
             virtual size_t Position() = 0;
+
+            /* the content row the cursor is drawn on; always zero for single
+            line inputs */
+            virtual size_t Row() { return 0; }
             virtual InputMode GetInputMode() = 0;
     };
 }
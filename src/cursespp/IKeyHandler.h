@@ -35,11 +35,32 @@
 #pragma once
 
 #include <string>
+#include <cursespp/KeyId.h>
 
 namespace cursespp {
     class IKeyHandler {
         public:
             virtual ~IKeyHandler() { }
-            virtual bool KeyPress(const std::string& key) = 0;
+
+            /* the main loop dispatches interned KeyIds; the string overload
+            remains for compatibility. implementations override one or the
+            other -- each forwards to the other by default, and the guard
+            stops a handler that overrides neither after a single hop. */
+            virtual bool KeyPress(const std::string& key) {
+                return this->KeyPress(key::Intern(key));
+            }
+
+            virtual bool KeyPress(KeyId key) {
+                if (this->forwarding) {
+                    return false;
+                }
+                this->forwarding = true;
+                bool result = this->KeyPress(key::Name(key));
+                this->forwarding = false;
+                return result;
+            }
+
+        private:
+            bool forwarding{ false };
     };
 }
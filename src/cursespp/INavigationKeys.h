@@ -35,6 +35,7 @@
 #pragma once
 
 #include <string>
+#include <cursespp/KeyId.h>
 
 namespace cursespp {
     class INavigationKeys {
@@ -64,5 +65,28 @@ namespace cursespp {
             virtual std::string End() = 0;
             virtual std::string Prev() = 0;
             virtual std::string Mode() = 0;
+
+            /* KeyId overloads. default to the string versions, so existing
+            implementations keep working; override to avoid the compares. */
+            virtual bool Up(KeyId key) { return this->Up(key::Name(key)); }
+            virtual bool Down(KeyId key) { return this->Down(key::Name(key)); }
+            virtual bool Left(KeyId key) { return this->Left(key::Name(key)); }
+            virtual bool Right(KeyId key) { return this->Right(key::Name(key)); }
+            virtual bool Next(KeyId key) { return this->Next(key::Name(key)); }
+            virtual bool PageUp(KeyId key) { return this->PageUp(key::Name(key)); }
+            virtual bool PageDown(KeyId key) { return this->PageDown(key::Name(key)); }
+            virtual bool Home(KeyId key) { return this->Home(key::Name(key)); }
+            virtual bool End(KeyId key) { return this->End(key::Name(key)); }
+            virtual bool Prev(KeyId key) { return this->Prev(key::Name(key)); }
+            virtual bool Mode(KeyId key) { return this->Mode(key::Name(key)); }
+
+            /* editing keys, used by TextInput and TextArea. not pure, so
+            existing implementations keep working. */
+            virtual std::string Undo() { return "M-u"; }
+            virtual std::string Redo() { return "M-e"; }
+            virtual bool Undo(const std::string& key) { return this->Undo() == key; }
+            virtual bool Redo(const std::string& key) { return this->Redo() == key; }
+            virtual bool Undo(KeyId key) { return this->Undo(key::Name(key)); }
+            virtual bool Redo(KeyId key) { return this->Redo(key::Name(key)); }
     };
 }
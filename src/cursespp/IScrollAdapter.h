@@ -36,6 +36,7 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 #include <cursespp/Colors.h>
 
 namespace cursespp {
@@ -70,6 +71,23 @@ namespace cursespp {
                     virtual Color GetAttrs(size_t line) = 0;
             };
 
+            /* a run of columns within a line drawn with its own attributes
+            (a color, optionally combined with A_BOLD etc). spans are sorted,
+            don't overlap, and columns outside of them use the line's attrs. */
+            struct Span {
+                size_t column, length;
+                int64_t attrs;
+            };
+
+            typedef std::vector<Span> Spans;
+
+            /* an entry that styles parts of its lines differently */
+            class IStyledEntry : public IEntry {
+                public:
+                    virtual ~IStyledEntry() { }
+                    virtual void GetSpans(size_t line, Spans& target) = 0;
+            };
+
             typedef std::shared_ptr<IEntry> EntryPtr;
 
             virtual void SetDisplaySize(size_t width, size_t height) = 0;
@@ -78,5 +96,17 @@ namespace cursespp {
             virtual void DrawPage(ScrollableWindow* window, size_t index, ScrollPosition& result) = 0;
     };
 
+    /* optionally implemented by adapters that keep track of their widest
+    entry as entries are added, so callers never have to measure them. an
+    adapter that can't tell (e.g. it holds entries it doesn't know how to
+    measure) returns Unknown, and the caller measures them itself. */
+    class IMeasuredAdapter {
+        public:
+            static const size_t Unknown = (size_t) -1;
+
+            virtual ~IMeasuredAdapter() { }
+            virtual size_t GetMaxEntryWidth() = 0;
+    };
+
     typedef std::shared_ptr<IScrollAdapter> IScrollAdapterPtr;
 }
@@ -59,9 +59,11 @@ namespace cursespp {
             InputOverlay& SetValidator(std::shared_ptr<IValidator> validator);
             InputOverlay& SetWidth(int width);
             InputOverlay& SetInputMode(IInput::InputMode mode);
+            InputOverlay& SetAutocomplete(IAutocompleteProviderPtr provider);
 
             virtual void Layout();
-            virtual bool KeyPress(const std::string& key);
+            using OverlayBase::KeyPress;
+            virtual bool KeyPress(KeyId key);
 
         protected:
             virtual void OnVisibilityChanged(bool visible);
@@ -0,0 +1,94 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cursespp {
+    /* captures the key, mouse, resize and paste events processed by App::Run(),
+    with timestamps relative to when recording started. the result can be
+    saved to disk and played back later with an InputReplayer. */
+    class InputRecorder {
+        public:
+            struct Event {
+                enum Type {
+                    Key = 0,
+                    Mouse = 1,
+                    Resize = 2,
+                    Paste = 3
+                };
+
+                Type type{ Key };
+                int64_t time{ 0 }; /* ms since recording started */
+                std::string key;   /* Key */
+                int x{ 0 }, y{ 0 };  /* Mouse */
+                int64_t state{ 0 };  /* Mouse (button state) */
+                int width{ 0 }, height{ 0 }; /* Resize */
+                std::string text;  /* Paste */
+            };
+
+            using EventList = std::vector<Event>;
+
+            InputRecorder();
+            virtual ~InputRecorder();
+
+            InputRecorder(const InputRecorder& other) = delete;
+            InputRecorder& operator=(const InputRecorder& other) = delete;
+
+            void Start();
+            void Stop();
+            bool IsRecording() const { return this->recording; }
+
+            void RecordKey(const std::string& key);
+            void RecordMouse(int x, int y, int64_t state);
+            void RecordResize(int width, int height);
+            void RecordPaste(const std::string& text);
+
+            const EventList& GetEvents() const { return this->events; }
+            void Clear();
+
+            bool Save(const std::string& filename) const;
+            static bool Load(const std::string& filename, EventList& target);
+
+        private:
+            int64_t Elapsed() const;
+
+            EventList events;
+            int64_t startedAt;
+            bool recording;
+    };
+}
@@ -0,0 +1,98 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cursespp/InputRecorder.h>
+
+namespace cursespp {
+    /* plays back events captured by an InputRecorder through App::Run(),
+    and measures how long it takes each event to reach the screen (i.e. the
+    time until the next completed Window::WriteToScreen()).
+
+    while attached the replayer also drives App::Now(): in RealTime mode the
+    clock advances with the wall clock, in Unthrottled mode it jumps straight
+    to each event's recorded time so the session runs as fast as the app can
+    process it. */
+    class InputReplayer {
+        public:
+            using Event = InputRecorder::Event;
+            using EventList = InputRecorder::EventList;
+
+            enum Speed {
+                RealTime = 0,
+                Unthrottled = 1
+            };
+
+            struct Sample {
+                size_t index;
+                Event::Type type;
+                std::string key;
+                int64_t latencyUs; /* -1 if the event never produced a frame */
+            };
+
+            using SampleList = std::vector<Sample>;
+
+            InputReplayer(const EventList& events, Speed speed = Unthrottled);
+            virtual ~InputReplayer();
+
+            InputReplayer(const InputReplayer& other) = delete;
+            InputReplayer& operator=(const InputReplayer& other) = delete;
+
+            void Start();
+            bool Poll(Event& target);
+            void OnFrameWritten();
+            bool Finished() const;
+
+            int64_t Now() const;
+            int64_t NextEventDelay() const;
+
+            Speed GetSpeed() const { return this->speed; }
+            const SampleList& GetSamples() const { return this->samples; }
+            std::string Report() const;
+
+        private:
+            void Resolve(int64_t latencyUs);
+
+            EventList events;
+            SampleList samples;
+            Speed speed;
+            size_t next;
+            bool outstanding;
+            int64_t dispatchedAtUs;
+            int64_t startedAt;
+            int64_t startedAtSteady;
+            int64_t virtualTime;
+    };
+}
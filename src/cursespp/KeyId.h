@@ -0,0 +1,110 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace cursespp {
+    /* an interned key name. key names are mapped to small integers once, when
+    they are read, so handlers can dispatch using integer compares instead of
+    string compares. commonly used keys have fixed, compile-time ids; anything
+    else (M- sequences, printable characters, etc) is assigned an id on first
+    use. ids are only meaningful within a single process. */
+    struct KeyId {
+        constexpr KeyId() : value(0) { }
+        constexpr explicit KeyId(int32_t value) : value(value) { }
+
+        constexpr bool operator==(const KeyId& other) const { return value == other.value; }
+        constexpr bool operator!=(const KeyId& other) const { return value != other.value; }
+        constexpr bool operator<(const KeyId& other) const { return value < other.value; }
+
+        int32_t value;
+    };
+
+    namespace key {
+        constexpr KeyId None { 0 };
+        constexpr KeyId Up { 1 };
+        constexpr KeyId Down { 2 };
+        constexpr KeyId Left { 3 };
+        constexpr KeyId Right { 4 };
+        constexpr KeyId PageUp { 5 };
+        constexpr KeyId PageDown { 6 };
+        constexpr KeyId Home { 7 };
+        constexpr KeyId End { 8 };
+        constexpr KeyId Tab { 9 };
+        constexpr KeyId BackTab { 10 };
+        constexpr KeyId Enter { 11 };
+        constexpr KeyId Backspace { 12 };
+        constexpr KeyId Delete { 13 };
+        constexpr KeyId Insert { 14 };
+        constexpr KeyId Escape { 15 };
+        constexpr KeyId Space { 16 };
+        constexpr KeyId Resize { 17 };
+        constexpr KeyId Mouse { 18 };
+        constexpr KeyId MetaBackspace { 19 };
+        constexpr KeyId MetaEnter { 20 };
+        constexpr KeyId F1 { 21 };
+        constexpr KeyId F2 { 22 };
+        constexpr KeyId F3 { 23 };
+        constexpr KeyId F4 { 24 };
+        constexpr KeyId F5 { 25 };
+        constexpr KeyId F6 { 26 };
+        constexpr KeyId F7 { 27 };
+        constexpr KeyId F8 { 28 };
+        constexpr KeyId F9 { 29 };
+        constexpr KeyId F10 { 30 };
+        constexpr KeyId F11 { 31 };
+        constexpr KeyId F12 { 32 };
+
+        /* returns the id for the specified (normalized) key name, assigning a
+        new one if it hasn't been seen before. */
+        KeyId Intern(const std::string& name);
+
+        /* returns the name the specified id was interned from, or an empty
+        string if the id is unknown. the reference remains valid for the
+        lifetime of the process. */
+        const std::string& Name(KeyId id);
+    }
+}
+
+namespace std {
+    template <> struct hash<cursespp::KeyId> {
+        size_t operator()(const cursespp::KeyId& id) const {
+            return std::hash<int32_t>()(id.value);
+        }
+    };
+}
@@ -0,0 +1,106 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cursespp/KeyId.h>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cursespp {
+    /* a table of key bindings. a binding is a sequence of one or more keys
+    separated by spaces, e.g. "^S", "g g" or "^X ^S", using the same names
+    key::Read() produces (plus SPACE, TAB, ESC and ENTER as aliases). the
+    table is compiled into a trie of KeyIds, so matching a key against a node
+    is a single hash lookup. see KeymapDispatcher. */
+    class Keymap {
+        public:
+            using Action = std::function<void()>;
+
+            struct Binding {
+                std::string sequence;
+                std::string caption;
+                std::vector<KeyId> keys;
+                Action action;
+            };
+
+            using BindingList = std::vector<Binding>;
+
+            static const int Root = 0;
+            static const int NoNode = -1;
+
+            Keymap();
+            virtual ~Keymap();
+
+            Keymap(const Keymap& other) = delete;
+            Keymap& operator=(const Keymap& other) = delete;
+
+            bool Bind(
+                const std::string& sequence,
+                Action action,
+                const std::string& caption = "");
+
+            bool Unbind(const std::string& sequence);
+            void Clear();
+
+            bool Invoke(const std::string& sequence) const;
+
+            const BindingList& Bindings() const { return this->bindings; }
+            size_t Generation() const { return this->generation; }
+
+            /* trie traversal */
+            int Next(int node, KeyId key) const;
+            bool HasChildren(int node) const;
+            bool HasAction(int node) const;
+            void Run(int node) const;
+
+            static bool Parse(const std::string& sequence, std::vector<KeyId>& target);
+
+        private:
+            struct Node {
+                std::unordered_map<KeyId, int> children;
+                int binding{ -1 };
+            };
+
+            void Insert(int bindingIndex);
+            void Compile();
+            int Find(const std::vector<KeyId>& keys) const;
+
+            BindingList bindings;
+            std::vector<Node> nodes;
+            size_t generation;
+    };
+}
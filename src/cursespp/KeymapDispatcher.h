@@ -0,0 +1,92 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cursespp/Keymap.h>
+#include <f8n/runtime/IMessageTarget.h>
+#include <memory>
+#include <unordered_map>
+
+namespace cursespp {
+    class IWindow;
+
+    /* resolves keys against layered keymaps. layers are owned by windows
+    (usually layouts or overlays); a key is matched against the focused
+    window's layer first, then each of its ancestors, then the active top
+    level layout or overlay, then the global layer. the first layer that
+    recognizes the key handles it. each step is one hash lookup per layer.
+
+    if the key starts a chord, subsequent keys continue it in that layer. if
+    no key arrives within the chord timeout, the chord is abandoned -- unless
+    the prefix itself is bound, in which case that binding runs. the timeout
+    is driven by the shared message queue, so it fires from the main loop. */
+    class KeymapDispatcher : public f8n::runtime::IMessageTarget {
+        public:
+            using KeymapPtr = std::shared_ptr<Keymap>;
+
+            KeymapDispatcher();
+            virtual ~KeymapDispatcher();
+
+            KeymapDispatcher(const KeymapDispatcher& other) = delete;
+            KeymapDispatcher& operator=(const KeymapDispatcher& other) = delete;
+
+            void Set(IWindow* owner, KeymapPtr keymap);
+            KeymapPtr Get(IWindow* owner) const;
+            void Remove(IWindow* owner);
+
+            void SetGlobal(KeymapPtr keymap);
+            KeymapPtr GetGlobal() const { return this->global; }
+
+            void SetChordTimeout(int64_t timeoutMs);
+            bool IsChordPending() const { return !!this->pendingMap; }
+            void Reset();
+
+            bool Dispatch(KeyId key, IWindow* focused, IWindow* top);
+
+            /* IMessageTarget */
+            virtual void ProcessMessage(f8n::runtime::IMessage &message) override;
+
+        private:
+            bool Begin(const KeymapPtr& keymap, KeyId key);
+            void ArmTimeout();
+
+            std::unordered_map<IWindow*, KeymapPtr> layers;
+            KeymapPtr global;
+            KeymapPtr pendingMap;
+            int pendingNode;
+            size_t pendingGeneration;
+            int64_t timeoutMs;
+    };
+}
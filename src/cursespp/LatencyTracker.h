@@ -0,0 +1,107 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cursespp {
+    /* measures the time between an input being read by the main loop and the
+    first completed screen update after it was dispatched. samples are kept in
+    per-category log-linear histograms so percentiles can be queried at any
+    time without storing individual samples. main thread only. */
+    class LatencyTracker {
+        public:
+            enum Category {
+                Navigation = 0,
+                TextInput = 1,
+                Overlay = 2,
+                Other = 3
+            };
+
+            static const size_t CategoryCount = 4;
+
+            class Histogram {
+                public:
+                    Histogram();
+
+                    void Add(int64_t valueUs);
+                    void Reset();
+
+                    size_t Count() const { return this->count; }
+                    int64_t Min() const { return this->count ? this->min : 0; }
+                    int64_t Max() const { return this->max; }
+                    int64_t Mean() const;
+                    int64_t Percentile(double percentile) const;
+
+                private:
+                    std::vector<size_t> buckets;
+                    size_t count;
+                    int64_t sum, min, max;
+            };
+
+            LatencyTracker();
+
+            LatencyTracker(const LatencyTracker& other) = delete;
+            LatencyTracker& operator=(const LatencyTracker& other) = delete;
+
+            void SetEnabled(bool enabled);
+            bool IsEnabled() const { return this->enabled; }
+
+            void OnInput(Category category, int64_t timestampUs);
+            void OnFrame(int64_t timestampUs);
+
+            const Histogram& Get(Category category) const;
+            size_t Unrendered() const { return this->unrendered; }
+            void Reset();
+
+            std::string Report() const;
+
+            static const char* CategoryName(Category category);
+            static int64_t Now();
+
+        private:
+            struct Pending {
+                Category category;
+                int64_t time;
+            };
+
+            std::vector<Pending> pending;
+            Histogram histograms[CategoryCount];
+            size_t unrendered;
+            bool enabled;
+    };
+}
@@ -39,6 +39,7 @@
 
 #include <sigslot/sigslot.h>
 #include <vector>
+#include <unordered_map>
 
 namespace cursespp {
     class LayoutBase:
@@ -90,7 +91,8 @@ namespace cursespp {
             virtual void Layout();
 
             /* IKeyHandler */
-            virtual bool KeyPress(const std::string& key);
+            using ILayout::KeyPress;
+            virtual bool KeyPress(KeyId key);
 
             /* IMouseHandler */
             virtual bool MouseEvent(const IMouseHandler::Event& mouseEvent);
@@ -108,13 +110,31 @@ namespace cursespp {
             IWindowPtr EnsureValidFocus();
 
         private:
-            void AddFocusable(IWindowPtr window);
-            void RemoveFocusable(IWindowPtr window);
-            void SortFocusables();
+            /* focusable windows are kept sorted by (focus order, id). the key
+            is captured when the window is indexed, so comparisons never have
+            to touch the window (or its refcount).
+
+            this is deliberately a vector and not a std::set: ILayout exposes
+            focus by index (Get/SetFocusIndex, GetFocusableAt) and FocusNext()
+            and FocusPrev() step an index, all of which stay O(1). lookups are
+            a binary search; an insert or erase is a binary search plus a
+            shift of a few pointer-sized entries, and layouts hold tens of
+            focusables at most, so the shift never shows up next to the
+            layout pass that triggers it. */
+            struct FocusEntry {
+                int order;
+                int id;
+                IWindowPtr window;
+            };
+
+            void AddFocusable(const IWindowPtr& window);
+            void RemoveFocusable(IWindow* window);
+            int FindFocusable(IWindow* window);
             void IndexFocusables();
 
             std::vector<IWindowPtr> children;
-            std::vector<IWindowPtr> focusable;
+            std::unordered_map<IWindow*, IWindowPtr> childLookup;
+            std::vector<FocusEntry> focusable;
             int focused;
             FocusMode focusMode;
     };
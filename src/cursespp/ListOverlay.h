@@ -63,12 +63,20 @@ namespace cursespp {
             ListOverlay& SetSelectedIndex(size_t index);
             ListOverlay& SetWidth(int width);
             ListOverlay& SetWidthPercent(int percent);
+
+            /* sizes the overlay to fit its content. adapters that implement
+            IMeasuredAdapter are asked for their widest entry; otherwise a
+            bounded sample of rows (first and last pages plus a few from the
+            middle) is measured. the result is cached until the adapter
+            changes. */
+            ListOverlay& SetAutoWidth(bool autoWidth);
             ListOverlay& SetAutoDismiss(bool autoDismiss);
 
             size_t GetSelectedIndex();
 
             virtual void Layout() override;
-            virtual bool KeyPress(const std::string& key) override;
+            using OverlayBase::KeyPress;
+            virtual bool KeyPress(KeyId key) override;
 
             void RefreshAdapter();
 
@@ -84,12 +92,16 @@ namespace cursespp {
             void RecalculateSize();
             bool ScrollbarVisible();
             void UpdateContents();
+            int MeasureContentWidth();
 
             std::string title;
             int x, y;
             int width, height;
             int setWidth, setWidthPercent;
-            bool autoDismiss;
+            bool autoDismiss, autoWidth;
+            size_t generation, measuredGeneration, measuredCount;
+            IScrollAdapter* measuredAdapter;
+            int measuredWidth;
             IScrollAdapterPtr adapter;
             std::shared_ptr<CustomListWindow> listWindow;
             std::shared_ptr<Window> scrollbar;
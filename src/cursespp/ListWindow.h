@@ -73,7 +73,8 @@ namespace cursespp {
 
             virtual const IScrollAdapter::ScrollPosition& GetScrollPosition();
 
-            virtual bool KeyPress(const std::string& key);
+            using ScrollableWindow::KeyPress;
+            virtual bool KeyPress(KeyId key);
             virtual bool MouseEvent(const IMouseHandler::Event& event);
 
             void SetScrollbarVisible(bool visible);
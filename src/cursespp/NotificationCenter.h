@@ -0,0 +1,105 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <f8n/runtime/IMessageTarget.h>
+#include <sigslot/sigslot.h>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace cursespp {
+    class ToastOverlay;
+
+    /* queues notifications, which may be posted from any thread, and shows
+    them one at a time in a single toast that's reused. a notification that
+    is identical to one already showing or waiting is merged into it
+    ("x N") instead of queued again, and a new notification replaces the
+    current one at most once per interval. a bounded history is kept, and
+    can be browsed with ShowHistory(). */
+    class NotificationCenter:
+        public f8n::runtime::IMessageTarget,
+        public sigslot::has_slots<>
+    {
+        public:
+            struct Notification {
+                std::string text;
+                size_t count;
+                int64_t time; /* steady clock, milliseconds */
+                int durationMs; /* -1 for SetDuration()'s */
+            };
+
+            NotificationCenter();
+            virtual ~NotificationCenter();
+
+            NotificationCenter(const NotificationCenter& other) = delete;
+            NotificationCenter& operator=(const NotificationCenter& other) = delete;
+
+            void Post(const std::string& text, int durationMs = -1);
+
+            void SetDuration(int durationMs);
+            void SetInterval(int intervalMs);
+            void SetHistorySize(size_t size);
+
+            /* most recent first */
+            std::vector<Notification> History();
+            void ShowHistory(const std::string& title);
+
+            /* hides the toast and forgets everything that's pending */
+            void Reset();
+
+            virtual void ProcessMessage(f8n::runtime::IMessage& message) override;
+
+        private:
+            void ShowNext();
+            void Hide();
+            void Schedule(int64_t delayMs);
+            void OnToastDismissed(ToastOverlay* toast);
+            int DurationOf(const Notification& notification);
+
+            static std::string Format(const Notification& notification);
+
+            std::mutex mutex;
+            std::deque<Notification> pending, history;
+            Notification current;
+            std::shared_ptr<ToastOverlay> toast;
+            bool showing, dirty, flushPosted, hiding, toastVisible;
+            int64_t shownAt;
+            int durationMs, intervalMs;
+            size_t historySize;
+    };
+}
@@ -0,0 +1,78 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cursespp/IAutocompleteProvider.h>
+#include <memory>
+#include <mutex>
+
+namespace cursespp {
+    /* an autocomplete provider backed by a sorted array of values. a query
+    is two binary searches to find the block of values that start with it
+    (ignoring ASCII case), then a single pass over that block to pick the
+    best `limit` of them by score, shorter values first on ties. values can
+    be added at any time. the next query sorts just the new values and merges
+    them into a copy of the array, outside the lock, then publishes the copy;
+    queries search an immutable snapshot, so Add() never waits on one. */
+    class PrefixIndex : public IAutocompleteProvider {
+        public:
+            PrefixIndex();
+            virtual ~PrefixIndex();
+
+            PrefixIndex(const PrefixIndex& other) = delete;
+            PrefixIndex& operator=(const PrefixIndex& other) = delete;
+
+            void Reserve(size_t count);
+            void Add(const std::string& value, int64_t score = 0);
+            void Clear();
+            size_t Size();
+
+            virtual void Suggest(
+                const std::string& query,
+                size_t limit,
+                const std::atomic<bool>& cancelled,
+                Suggestions& results) override;
+
+        private:
+            using SnapshotPtr = std::shared_ptr<const Suggestions>;
+
+            SnapshotPtr Snapshot();
+
+            std::mutex mutex;
+            SnapshotPtr entries; /* sorted, no duplicates */
+            Suggestions added; /* not merged in yet */
+            size_t clears;
+    };
+}
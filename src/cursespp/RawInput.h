@@ -0,0 +1,115 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cursespp/KeyId.h>
+#include <cstdint>
+#include <string>
+
+namespace cursespp {
+    /* an optional replacement for wgetch() + key::Read(). reads the terminal
+    in bulk and decodes it with a byte-at-a-time state machine: plain and
+    control characters, UTF-8, ESC/meta, CSI and SS3 sequences (cursor, editing
+    and function keys, with modifiers), and SGR/X10 mouse reports. key names
+    match what key::Read() produces, so existing handlers see the same
+    strings, and each key is also delivered as an interned KeyId.
+
+    bracketed paste is enabled while running, so pasted text arrives as a
+    single Paste event rather than one key event per character.
+
+    POSIX only; on other platforms Read() never produces events. */
+    class RawInput {
+        public:
+            struct Event {
+                enum Type {
+                    Key = 0,
+                    Mouse = 1,
+                    Paste = 2
+                };
+
+                Type type{ Key };
+                KeyId id;
+                std::string name; /* Key */
+                int x{ 0 }, y{ 0 }; /* Mouse */
+                int64_t state{ 0 }; /* Mouse, as mmask_t bits */
+                std::string text; /* Paste */
+            };
+
+            RawInput(int fd = 0);
+            virtual ~RawInput();
+
+            RawInput(const RawInput& other) = delete;
+            RawInput& operator=(const RawInput& other) = delete;
+
+            void Start(bool mouse);
+            void Stop();
+
+            bool Read(Event& target, int timeoutMs);
+            void Feed(const char* data, size_t length);
+
+        private:
+            enum State {
+                Ground,
+                Escape,
+                Csi,
+                Ss3,
+                Utf8,
+                MouseX10,
+                Pasting
+            };
+
+            bool Next(Event& target);
+            bool Step(unsigned char c, Event& target);
+            bool Flush(Event& target);
+            bool PasteChunk(Event& target);
+            bool DispatchCsi(unsigned char final, Event& target);
+            bool DispatchSs3(unsigned char final, Event& target);
+            bool DispatchMouse(int button, int x, int y, bool release, Event& target);
+            bool EmitKey(const std::string& name, Event& target);
+            size_t Fill(int timeoutMs);
+
+            int fd;
+            bool started;
+            std::string input;
+            size_t position;
+            State state;
+            std::string sequence;
+            size_t utf8Remaining;
+            std::string paste;
+            int pressedButton;
+            int lastClickButton;
+            int64_t lastClickTime;
+    };
+}
@@ -60,7 +60,8 @@ namespace cursespp {
             virtual void Show();
             virtual void OnDimensionsChanged();
 
-            virtual bool KeyPress(const std::string& key);
+            using IKeyHandler::KeyPress;
+            virtual bool KeyPress(KeyId key);
             virtual bool MouseEvent(const IMouseHandler::Event& event);
 
             virtual void ScrollToTop();
@@ -37,6 +37,7 @@
 #include <cursespp/IKeyHandler.h>
 #include <cursespp/Window.h>
 #include <cursespp/Text.h>
+#include <cursespp/Keymap.h>
 #include <functional>
 
 namespace cursespp {
@@ -59,10 +60,16 @@ namespace cursespp {
 
             void SetChangedCallback(ChangedCallback callback);
 
+            /* renders the keymap's captioned bindings as shortcuts, and keeps
+            them in sync as the keymap changes. activating a shortcut runs
+            its binding, unless a ChangedCallback is set. */
+            void SetKeymap(std::shared_ptr<Keymap> keymap);
+
             void RemoveAll();
             void SetActive(const std::string& key);
 
-            virtual bool KeyPress(const std::string& key) override;
+            using IKeyHandler::KeyPress;
+            virtual bool KeyPress(KeyId key) override;
             virtual bool MouseEvent(const IMouseHandler::Event& mouseEvent) override;
 
         protected:
@@ -72,6 +79,8 @@ namespace cursespp {
         private:
             size_t CalculateLeftPadding();
             int getActiveIndex();
+            void SyncKeymap();
+            void Activate(const std::string& key);
 
             struct Position {
                 int offset{ 0 }, width{ 0 };
@@ -93,6 +102,8 @@ namespace cursespp {
             using EntryList = std::vector<std::shared_ptr<Entry>>;
 
             ChangedCallback changedCallback;
+            std::shared_ptr<Keymap> keymap;
+            size_t keymapGeneration{ 0 };
             EntryList entries;
             std::string activeKey, originalKey;
             text::TextAlign alignment;
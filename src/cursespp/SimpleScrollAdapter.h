@@ -42,7 +42,7 @@
 #include <map>
 
 namespace cursespp {
-    class SimpleScrollAdapter : public ScrollAdapterBase {
+    class SimpleScrollAdapter : public ScrollAdapterBase, public IMeasuredAdapter {
         public:
             sigslot::signal1<SimpleScrollAdapter*> Changed;
 
@@ -56,6 +56,10 @@ namespace cursespp {
             virtual size_t GetEntryCount();
             virtual EntryPtr GetEntry(cursespp::ScrollableWindow* window, size_t index);
 
+            /* may overestimate after the widest entry has been trimmed, and
+            is Unknown while any entry isn't a SingleLineEntry */
+            virtual size_t GetMaxEntryWidth() override;
+
             void SetSelectable(bool selectable);
             void AddEntry(const std::string& entry);
             std::string StringAt(size_t index);
@@ -66,6 +70,8 @@ namespace cursespp {
             std::map<size_t, Color> indexToColor;
             EntryList entries;
             size_t maxEntries;
+            size_t maxEntryWidth;
+            size_t unmeasured; /* entries that aren't SingleLineEntry */
             bool selectable;
     };
 }
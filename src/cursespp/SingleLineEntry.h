@@ -38,7 +38,7 @@
 #include <cursespp/Colors.h>
 
 namespace cursespp {
-    class SingleLineEntry : public IScrollAdapter::IEntry {
+    class SingleLineEntry : public IScrollAdapter::IStyledEntry {
         public:
             SingleLineEntry(const std::string& value);
             virtual ~SingleLineEntry() { }
@@ -47,14 +47,20 @@ namespace cursespp {
             virtual Color GetAttrs(size_t line);
             virtual size_t GetLineCount();
             virtual std::string GetLine(size_t line);
+            virtual void GetSpans(size_t line, IScrollAdapter::Spans& target);
 
             void SetAttrs(Color attrs);
 
+            /* spans must be added in column order, and may not overlap */
+            void AddSpan(size_t column, size_t length, int64_t attrs);
+            void ClearSpans();
+
             std::string GetValue() { return value; }
 
         private:
             size_t width;
             std::string value;
             Color attrs;
+            IScrollAdapter::Spans spans;
     };
 }
\ No newline at end of file
@@ -34,6 +34,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -48,7 +49,24 @@ namespace cursespp {
         std::string Ellipsize(const std::string& str, size_t len);
         std::string Align(const std::string& str, TextAlign align, size_t len);
         std::vector<std::string> BreakLines(const std::string& line, size_t width);
+
+        /* a row of wrapped text: a range of the original string, the index
+        of its first code point, and that code point's column */
+        struct WrappedRow {
+            size_t offset, bytes;
+            size_t index, column;
+        };
+
+        /* breaks a single line (no newlines) at the same places BreakLines()
+        would, but returns ranges into the original string instead of copies,
+        so callers can map offsets between text and screen. whitespace at a
+        break is kept in the range's index span but not in its bytes. */
+        void WrapLine(const std::string& line, size_t width, std::vector<WrappedRow>& rows);
         std::vector<std::string> Split(const std::string& str, const std::string& delimiters = " ", bool trimEmpty = false);
+
+        /* the number of columns a single code point occupies, like wcwidth(),
+        for measuring text one code point at a time without allocating. */
+        size_t Columns(uint32_t codepoint);
     }
 
     namespace key {
@@ -0,0 +1,125 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cursespp/curses_config.h>
+#include <cursespp/ScrollableWindow.h>
+#include <cursespp/IInput.h>
+#include <cursespp/TextBuffer.h>
+#include <cursespp/EditHistory.h>
+#include <cursespp/Text.h>
+#include <sigslot/sigslot.h>
+#include <vector>
+
+namespace cursespp {
+    /* a multi-line text editor. the document is kept as a gap buffer of
+    lines: lines above and below the cursor are stored whole, and only the
+    cursor's line is held in an editable TextBuffer, so typing costs the
+    same however large the document is. lines are wrapped (the same way as
+    text::BreakLines()) only when they are drawn, and only the visible rows
+    are ever wrapped or drawn. */
+    class TextArea:
+        public ScrollableWindow,
+        public IInput
+    {
+        public:
+            sigslot::signal1<TextArea*> TextChanged;
+
+            TextArea(IWindow *parent = nullptr);
+            virtual ~TextArea();
+
+            virtual bool Write(const std::string& key);
+            virtual bool Paste(const std::string& text);
+            virtual size_t Length();
+            virtual size_t Position();
+            virtual size_t Row();
+            virtual InputMode GetInputMode() { return IInput::InputNormal; }
+
+            using ScrollableWindow::KeyPress;
+            virtual bool KeyPress(KeyId key);
+            virtual bool MouseEvent(const IMouseHandler::Event& event);
+
+            virtual void PageUp();
+            virtual void PageDown();
+            virtual void OnAdapterChanged();
+            virtual void ProcessMessage(f8n::runtime::IMessage& message) override;
+
+            void SetText(const std::string& text);
+            std::string GetText();
+
+            size_t GetLineCount() { return above.size() + 1 + below.size(); }
+            const std::string& GetLine(size_t index);
+
+            size_t GetCursorLine() { return above.size(); }
+            size_t GetCursorColumn() { return current.Position(); }
+            void SetCursor(size_t line, size_t column);
+
+            /* bound to INavigationKeys::Undo() and Redo(), M-u and M-e by default.
+            SetText() clears the history. */
+            bool Undo();
+            bool Redo();
+            EditHistory& GetHistory() { return this->history; }
+
+        protected:
+            virtual void OnRedraw();
+            virtual void OnDimensionsChanged();
+
+        private:
+            class Adapter;
+
+            void MoveToLine(size_t line);
+            void Insert(const std::string& text);
+            void BreakLine();
+            void EraseForward(size_t count);
+            void Apply(const EditHistory::Transaction& transaction, bool undo);
+            void Changed();
+            void ScrollToCursor();
+            void DrawPage(size_t index);
+            size_t RowCount(size_t line);
+            const std::vector<text::WrappedRow>& CursorLineRows();
+            size_t CursorRow();
+
+            std::vector<std::string> above, below; /* below is reversed */
+            TextBuffer current;
+            EditHistory history;
+            size_t preferredColumn;
+            size_t cursorRow, cursorColumn;
+            std::vector<text::WrappedRow> rows;
+            std::vector<text::WrappedRow> cursorLineRows;
+            size_t cursorLineWidth; /* 0 when cursorLineRows is stale */
+            size_t pendingTop;
+            std::shared_ptr<Adapter> documentAdapter;
+    };
+}
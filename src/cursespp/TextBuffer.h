@@ -0,0 +1,115 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2007-2019 musikcube team
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the author nor the names of other contributors may
+//      be used to endorse or promote products derived from this software
+//      without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cursespp {
+    /* editable UTF-8 text with a cursor, stored as a gap buffer: everything
+    before the cursor lives in one stack, everything after it in another
+    (reversed), so inserts and deletes at the cursor, and moving the cursor
+    one character at a time, are O(1). per-character byte and column widths
+    are kept alongside, so the cursor's code point and column offsets are
+    always known without re-scanning the string. jumping the cursor is
+    O(distance). */
+    class TextBuffer {
+        public:
+            static const size_t npos = (size_t) -1;
+
+            TextBuffer();
+
+            void Assign(const std::string& text);
+            void Clear();
+
+            /* inserts at the cursor and moves the cursor past the new text.
+            stops early if the total width would exceed maxColumns. returns
+            the number of code points inserted. */
+            size_t Insert(const std::string& text, size_t maxColumns = npos);
+
+            bool EraseBefore(); /* backspace */
+            bool EraseAfter(); /* delete */
+
+            bool MoveTo(size_t position);
+
+            size_t Length() const { return before.size() + after.size(); }
+            size_t Position() const { return before.size(); }
+            size_t Columns() const { return beforeColumns + afterColumns; }
+            size_t Column() const { return beforeColumns; }
+            bool Empty() const { return this->Length() == 0; }
+
+            const std::string& Text() const;
+
+            /* returns up to maxColumns worth of text starting at the specified
+            code point; cost is proportional to the distance from the cursor
+            plus the size of the slice, not the size of the buffer. */
+            std::string Slice(size_t start, size_t maxColumns, size_t* columns = nullptr) const;
+
+            /* returns `count` code points starting at `start`, same cost as
+            Slice() */
+            std::string Range(size_t start, size_t count) const;
+
+            /* the first code point to display if the text is shown in a
+            window `width` columns wide and the cursor must remain visible.
+            optionally returns the cursor's column relative to that point. */
+            size_t VisibleStart(size_t width, size_t* cursorColumn = nullptr) const;
+
+            /* the code point shown `column` columns to the right of `start`
+            (e.g. the one under a mouse click), clamped to the end of the
+            text. costs O(column). */
+            size_t PositionAt(size_t start, size_t column) const;
+
+        private:
+            struct Glyph {
+                uint8_t bytes;
+                uint8_t columns;
+            };
+
+            void Dirty() { this->dirty = true; }
+
+            std::string Copy(size_t start, size_t maxCount, size_t maxColumns, size_t* columns) const;
+
+            /* `after` and `afterBytes` are stored back-to-front so the
+            character immediately following the cursor is always at the end
+            of the container */
+            std::vector<Glyph> before, after;
+            std::string beforeBytes, afterBytes;
+            size_t beforeColumns, afterColumns;
+
+            mutable std::string text;
+            mutable bool dirty;
+    };
+}
@@ -38,6 +38,9 @@
 #include <cursespp/Window.h>
 #include <cursespp/IInput.h>
 #include <cursespp/IKeyHandler.h>
+#include <cursespp/TextBuffer.h>
+#include <cursespp/EditHistory.h>
+#include <cursespp/Autocomplete.h>
 #include <sigslot/sigslot.h>
 #include <vector>
 
@@ -59,8 +62,10 @@ namespace cursespp {
             virtual ~TextInput();
 
             virtual void OnRedraw();
+            virtual void Blur();
 
             virtual bool Write(const std::string& key);
+            virtual bool Paste(const std::string& text);
             virtual size_t Length();
             virtual size_t Position();
 
@@ -70,11 +75,16 @@ namespace cursespp {
 
             virtual InputMode GetInputMode() { return this->inputMode; }
 
-            virtual bool KeyPress(const std::string& key);
+            using IKeyHandler::KeyPress;
+            virtual bool KeyPress(KeyId key);
             virtual bool MouseEvent(const IMouseHandler::Event& event);
 
             virtual void SetText(const std::string& value);
-            virtual std::string GetText() { return this->buffer; }
+            virtual std::string GetText() { return this->buffer.Text(); }
+
+            /* like SetText(), but recorded in the edit history, so it can be
+            undone. */
+            void Replace(const std::string& value);
 
             void SetRawKeyBlacklist(const std::vector<std::string>&& blacklist);
             void SetTruncate(bool truncate);
@@ -82,15 +92,34 @@ namespace cursespp {
             void SetEnterEnabled(bool enabled);
             Style GetStyle() { return style; }
 
+            /* bound to INavigationKeys::Undo() and Redo(), M-u and M-e by default.
+            SetText() clears the history. */
+            bool Undo();
+            bool Redo();
+            EditHistory& GetHistory() { return this->history; }
+
+            /* shows suggestions from the provider as the user types. pass
+            nullptr to turn suggestions off. */
+            void SetAutocomplete(
+                IAutocompleteProviderPtr provider,
+                size_t limit = Autocomplete::DEFAULT_LIMIT);
+
+            std::shared_ptr<Autocomplete> GetAutocomplete() { return this->autocomplete; }
+
+        protected:
+            virtual void OnVisibilityChanged(bool visible);
+
         private:
             bool OffsetPosition(int delta);
+            void Apply(const EditHistory::Transaction& transaction, bool undo);
 
             std::vector<std::string> rawBlacklist;
-            std::string buffer, hintText;
-            int position;
+            TextBuffer buffer;
+            EditHistory history;
+            std::shared_ptr<Autocomplete> autocomplete;
+            std::string hintText;
             bool enterEnabled;
             bool truncate;
-            size_t bufferLength;
             Style style;
             InputMode inputMode;
     };
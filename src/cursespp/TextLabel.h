@@ -69,7 +69,8 @@ namespace cursespp {
             virtual bool IsBold() { return this->bold; }
             virtual void OnRedraw();
 
-            virtual bool KeyPress(const std::string& key);
+            using IKeyHandler::KeyPress;
+            virtual bool KeyPress(KeyId key);
             virtual bool MouseEvent(const IMouseHandler::Event& event);
 
         private:
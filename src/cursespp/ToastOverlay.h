@@ -46,20 +46,30 @@ namespace cursespp {
         public:
             static void Show(const std::string& text, int durationMs = 3000);
 
+            sigslot::signal1<ToastOverlay*> Dismissed;
+
             virtual ~ToastOverlay();
 
             ToastOverlay(const ToastOverlay& other) = delete;
             ToastOverlay& operator=(const ToastOverlay& other) = delete;
 
             virtual void Layout() override;
-            virtual bool KeyPress(const std::string& key) override;
+            using OverlayBase::KeyPress;
+            virtual bool KeyPress(KeyId key) override;
             virtual void ProcessMessage(f8n::runtime::IMessage &message) override;
 
+            /* replaces the text in place; the toast is resized if visible */
+            void SetText(const std::string& text);
+
         protected:
             virtual void OnVisibilityChanged(bool visible) override;
+            virtual void OnDismissed() override;
 
         private:
+            friend class NotificationCenter;
+
             ToastOverlay(const std::string& text, long durationMs);
+            void Close();
 
             virtual void OnRedraw() override;
             void RecalculateSize();
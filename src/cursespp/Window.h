@@ -37,6 +37,9 @@
 #include <cursespp/curses_config.h>
 #include <cursespp/IWindow.h>
 #include <cursespp/INavigationKeys.h>
+#include <cursespp/HitTestIndex.h>
+#include <cursespp/KeymapDispatcher.h>
+#include <cursespp/CommandRegistry.h>
 #include <f8n/runtime/IMessageQueue.h>
 
 #ifdef WIN32
@@ -127,8 +130,15 @@ namespace cursespp {
             static void Unfreeze();
 
             static void SetNavigationKeys(std::shared_ptr<INavigationKeys> keys);
+            static INavigationKeys& NavigationKeys();
 
             static f8n::runtime::IMessageQueue& MessageQueue();
+            static HitTestIndex& HitTest();
+            static KeymapDispatcher& Keymaps();
+            static CommandRegistry& Commands();
+
+            /* installs a keymap layer owned by this window; see KeymapDispatcher */
+            void SetKeymap(std::shared_ptr<Keymap> keymap);
 
         protected:
 
@@ -138,8 +148,6 @@ namespace cursespp {
             void Remove(int messageType);
             bool FocusInParent();
 
-            static INavigationKeys& NavigationKeys();
-
             virtual void Create();
             virtual void Destroy();
             virtual void DecorateFrame();
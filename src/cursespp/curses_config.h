@@ -55,6 +55,12 @@
 
 #include <stdarg.h>
 
+/* ncurses 6.1+ can address colors and pairs beyond the range of a short */
+#if defined(NCURSES_EXT_COLORS) && defined(NCURSES_VERSION_MAJOR) && \
+    (NCURSES_VERSION_MAJOR > 6 || (NCURSES_VERSION_MAJOR == 6 && NCURSES_VERSION_MINOR >= 1))
+    #define CURSESPP_EXTENDED_COLORS 1
+#endif
+
 #define checked_wprintw(window, format, ...) \
     if (window && format) { wprintw(window, format, ##__VA_ARGS__); }
 